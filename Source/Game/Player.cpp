@@ -261,9 +261,7 @@ int terPlayer::registerUnitID(int unitID)
 
 const AttributeBase* terPlayer::unitAttribute(terUnitAttributeID id) const 
 { 
-	const AttributeBase* attr = attributeLibrary().find(AttributeIDBelligerent(id, belligerent())); 
-	if(!attr)
-		attr = attributeLibrary().find(AttributeIDBelligerent(id, BELLIGERENT_NONE)); 
+	const AttributeBase* attr = findUnitAttribute(id, belligerent());
 	xassert(attr);
 	return attr;
 }
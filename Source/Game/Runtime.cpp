@@ -31,6 +31,7 @@
 #include "files/files.h"
 #include "Localization.h"
 #include "codepages/codepages.h"
+#include "xfixed.h"
 
 #include <SDL.h>
 #include <SDL_hints.h>
@@ -679,6 +680,17 @@ void HTManager::initGraphics()
 	terScreenSizeY = terRenderDevice->GetSizeY();
 	terVisGeneric->SetData(terRenderDevice);
 
+    //Headless check that identical small meshes collapse into one command, aborts if not
+    if (const char* check_mesh_batch = check_command_line("check_mesh_batch")) {
+        int count = atoi(check_mesh_batch);
+        if (!terRenderDevice->CheckMeshBatching(0 < count ? count : 64)) {
+            ErrH.Abort("Mesh batching check failed, run it with graph=headless");
+        }
+    }
+    if (check_command_line("check_tile_budget") && !cInterfaceRenderDevice::CheckTileUpdateBudget()) {
+        ErrH.Abort("Tilemap update budget check failed");
+    }
+
 //---------------------
 	SetShadowType(terShadowType,terDrawMeshShadow,false);
 	terScene = terVisGeneric->CreateScene();
@@ -1064,6 +1076,16 @@ int SDL_main(int argc, char *argv[])
     //Parse version string
     decode_version(currentShortVersion, currentVersionNumbers);
 
+    //Fixed-point math must produce bit exact results in every build, release builds check it on request
+    xassert(xfx::checksum() == XFIXED_CHECKSUM);
+    if (check_command_line("check_xfixed")) {
+        uint32_t fixed_checksum = xfx::checksum();
+        printf("Fixed-point checksum %08X, expected %08X\n", fixed_checksum, XFIXED_CHECKSUM);
+        if (fixed_checksum != XFIXED_CHECKSUM) {
+            ErrH.Abort("Fixed-point math self check failed", XERR_CRITICAL, static_cast<int>(fixed_checksum));
+        }
+    }
+
     //Set DPI awareness, must be done before initializing SDL video subsystem
     //Some old versions of SDL2 may not have this hint defined
 #ifdef SDL_HINT_WINDOWS_DPI_AWARENESS
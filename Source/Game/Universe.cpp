@@ -90,7 +90,8 @@ void UpdateRegionMap(int x1,int y1,int x2,int y2)
 terUniverse::terUniverse(PNetCenter* net_client, MissionDescription& mission, PROGRESSCALLBACK loadProgressUpdate) :
 	terHyperSpace(net_client, mission), //mission может измениться в случае rePlay-а
 	UnitGrid(vMap.H_SIZE, vMap.V_SIZE),
-	cluster_column_(vMap.V_SIZE)
+	cluster_column_(vMap.V_SIZE),
+	bullet_targets_changes_(-1)
 {
 	loadProgressUpdate(0.5f);
 	xassert(vMap.H_SIZE && vMap.V_SIZE);
@@ -1383,6 +1384,21 @@ struct terRealCollisionOperator
 	}
 };
 
+struct terBulletTargetFilter
+{
+	bool operator()(const terUnitBase* p) const { return !(p->excludeCollision() & EXCLUDE_COLLISION_BULLET); }
+};
+
+const terUnitGridType::Subset& terUniverse::bulletTargets()
+{
+	if(bullet_targets_changes_ != UnitGrid.changes()){
+		terBulletTargetFilter filter;
+		UnitGrid.BuildSubset(bullet_targets_, filter);
+		bullet_targets_changes_ = UnitGrid.changes();
+	}
+	return bullet_targets_;
+}
+
 void terPlayer::CollisionQuant()
 {
 	MTL();
@@ -1395,7 +1411,13 @@ void terPlayer::CollisionQuant()
 				int y = p->position2D().yi();
 				int r = xm::round(p->radius());
 				terRealCollisionOperator op(p);
-				universe()->UnitGrid.Scan(x, y, r, op);
+				//Снаряды отбрасывают друг друга по маске исключения, в залпах их большинство в клетке.
+				//Выборка без них перебирает остальных в том же порядке, что и Scan, так что
+				//первое попадание и последовательность terLogicRND не меняются
+				if(p->excludeCollision() & EXCLUDE_COLLISION_BULLET)
+					universe()->UnitGrid.ScanSubset(universe()->bulletTargets(), x, y, r, op);
+				else
+					universe()->UnitGrid.Scan(x, y, r, op);
 			}
 		}
 		p->SetRealCollisionCount(terRealCollisionCount);
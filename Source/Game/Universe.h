@@ -113,6 +113,9 @@ public:
 	PlayerVect Players;
 	
 	terUnitGridType UnitGrid;
+
+	//UnitGrid без объектов, исключённых из столкновений со снарядами, см. terPlayer::CollisionQuant
+	const terUnitGridType::Subset& bulletTargets();
 	
 	cSpriteManager* pSpriteCongregation;
 	cSpriteManager* pSpriteCongregationProtection;
@@ -154,6 +157,9 @@ private:
 
 	MultiBodyDispatcher multibody_dispatcher;
 
+	terUnitGridType::Subset bullet_targets_;
+	int bullet_targets_changes_;
+
 	typedef std::vector<const SaveUnitLink*> SaveUnitLinkList;
 	SaveUnitLinkList saveUnitLinks_;
 
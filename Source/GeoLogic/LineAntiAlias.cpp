@@ -57,8 +57,7 @@ sRect& geoLine(int xbeg, int ybeg, int sx, int sy, int width, sRect& r)
 	else{ xL=vMap.XCYCL(xbeg+sx-width); xR=vMap.XCYCL(xbeg+width); }
 	if(sy>0) { yT=vMap.YCYCL(ybeg-width); yD=vMap.YCYCL(ybeg+sy+width); }
 	else { yT=vMap.YCYCL(ybeg+sy-width); yD=vMap.YCYCL(ybeg+width); }
-	vMap.recalcArea2Grid(xL, yT, xR, yD );
-	vMap.regRender(xL, yT, xR, yD);
+	//Сетку и отрисовку обновляет вызывающий, один раз за квант по всем линиям
 	r.left = xL; r.right = xR;
 	r.top = yT; r.bottom = yD;
 
@@ -165,8 +164,7 @@ sRect& LineAA(int Xd, int Yd, int Xf, int Yf, sRect& r)
 	else{ xL=vMap.XCYCL(Xf); xR=vMap.XCYCL(Xd); }
 	if(Yd < Yf) { yT=vMap.YCYCL(Yd); yD=vMap.YCYCL(Yf); }
 	else { yT=vMap.YCYCL(Yf); yD=vMap.YCYCL(Yd); }
-	vMap.recalcArea2Grid(xL, yT, xR, yD );
-	vMap.regRender(xL, yT, xR, yD);
+	//Сетку и отрисовку обновляет вызывающий, один раз за квант по всем линиям
 	r.left = xL; r.right = xR;
 	r.top = yT; r.bottom = yD;
 
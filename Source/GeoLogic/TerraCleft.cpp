@@ -16,6 +16,8 @@ const int cleftNodeBias    = 15;
 const int cleftBreakWidth =  4;
 const int cleftDepthMultipler = 10;
 
+const int cleftQuantCellBudget = 8192; //Ячеек карты на квант для отрисовки всей системы трещин
+
 sRect& LineAA(int Xd, int Yd, int Xf, int Yf, sRect& r);
 sRect& geoLine(int xbeg, int ybeg, int sx, int sy, int width, sRect& r);
 
@@ -30,40 +32,11 @@ inline int _xnoise1()
 	return terLogicRND(2*cleftChunkPosBias) - cleftChunkPosBias;
 }
 
-inline void union_rect(sRect& rDst, sRect& r1, sRect& r2)
-{
-	rDst.left  = (std::min)(r1.left, r2.left);
-	rDst.right = (std::max)(r1.right, r2.right);
-	rDst.top  = (std::min)(r1.top, r2.top);
-	rDst.bottom = (std::max)(r1.bottom, r2.bottom);
-}
-inline void update_map(int left, int right, int top, int bottom)
-{
-	if(right - left > (vMap.H_SIZE>>1))
-	{
-		update_map(0, left, top, bottom);
-		update_map(right, vMap.H_SIZE-1, top, bottom);
-	}
-	else if(bottom - top > (vMap.V_SIZE>>1))
-	{
-		update_map(left, right, 0, top);
-		update_map(left, right, bottom, vMap.V_SIZE-1);
-	}
-	else
-	{
-		if((left != right) && (top != bottom))
-		{
-			vMap.recalcArea2Grid(left, top, right, bottom);
-			vMap.regRender(left, top, right, bottom);
-		}
-	}
-}
-inline void update_map(const sRect& r)
+//Оценка числа ячеек, которые тронет отрезок
+inline int segment_cost(const CTerraCleft::Segment& s)
 {
-//	update_map(r.left, r.right, r.top, r.bottom);
-
-	vMap.recalcArea2Grid(r.left, r.top, r.right, r.bottom);
-	vMap.regRender(r.left, r.top, r.right, r.bottom);
+	int len = (std::max)(xm::abs(s.b.x - s.a.x), xm::abs(s.b.y - s.a.y));
+	return len * (s.width ? 2*s.width - 1 : 2) + 1;
 }
 
 ///////////////////////////////////////////////
@@ -114,7 +87,7 @@ CTerraCleft& CTerraCleft::attach(CTerraCleft& cleft)
 	return cleft;
 }
 
-int CTerraCleft::quant(sRect& r)
+int CTerraCleft::quant(SegmentList& segments)
 {
 	if(m_points.size() >= cleftChunkCount)
 		return 0;
@@ -124,17 +97,17 @@ int CTerraCleft::quant(sRect& r)
 	Vect2i& b = m_points.back();
 
 
-	sRect r2;
 	if(a != b)
-		union_rect(r, r, LineAA(a.x, a.y, b.x, b.y, r2));
+	{
+		Segment s = { a, b, 0 };
+		segments.push_back(s);
+	}
 
 	return 1;
 }
 
-int CTerraCleft::quant_g(sRect& r)
+int CTerraCleft::quant_g(SegmentList& segments)
 {
-	sRect r2;
-
 	width+=(1<<11)+(1<<10)+(1<<12) + 1;
 
 	PointList::iterator it = m_points.begin();
@@ -147,7 +120,10 @@ int CTerraCleft::quant_g(sRect& r)
 			break;
 
 		if(a != b)
-			union_rect(r, r, geoLine(a.x, a.y, b.x - a.x, b.y - a.y, width>>16, r2));
+		{
+			Segment s = { a, b, width>>16 };
+			segments.push_back(s);
+		}
 	}
 
 	return ((width>>16) < cleftBreakWidth) && ((width & 0xFF) < cleftDepthMultipler);
@@ -160,6 +136,7 @@ int CTerraCleft::quant_g(sRect& r)
 CTerraCleftSystem::CTerraCleftSystem()
 {
 	m_bGrowing = 1;
+	m_bStopped = 0;
 }
 
 #define ID(i, j) (((i)<<24)|(j))
@@ -285,13 +262,13 @@ void CTerraCleftSystem::init(int type, const Vect2i& pos1, const Vect2i& pos2)
 
 int CTerraCleftSystem::quant()
 {
-	sRect rUpdate = {INT_MAX, INT_MAX, -INT_MAX, -INT_MAX};
 	int nstops = 0;
 
+	//Все трещины каждый квант и в порядке списка: от этого зависит последовательность terLogicRND
 	CleftList::iterator it;
 	FOR_EACH(m_clefts, it)
 	{
-		if((it->processing == prcGo) && !it->quant(rUpdate))
+		if((it->processing == prcGo) && !it->quant(m_segments))
 		{
 			it->activate_siblings();
 
@@ -303,15 +280,90 @@ int CTerraCleftSystem::quant()
 				nstops++;
 			}
 		}
-		else if((it->processing == prcGrow) && !it->quant_g(rUpdate))
+		else if((it->processing == prcGrow) && !it->quant_g(m_segments))
 		{
 			it->processing = prcStop;
 			nstops++;
 		}
 	}
-	//update_map(rUpdate);
 
-	return nstops != m_clefts.size();
+	//Отрезки рисуются в порядке появления, но не больше бюджета ячеек за квант, остальные ждут следующего.
+	//Бюджет в ячейках, а не во времени, так что карта меняется одинаково на всех машинах.
+	//Первый отрезок рисуется всегда, поэтому бюджет может быть превышен на один отрезок
+	int budget = cleftQuantCellBudget;
+	while(!m_segments.empty() && budget > 0)
+	{
+		const CTerraCleft::Segment& s = m_segments.front();
+		sRect r;
+		if(s.width)
+			geoLine(s.a.x, s.a.y, s.b.x - s.a.x, s.b.y - s.a.y, s.width, r);
+		else
+			LineAA(s.a.x, s.a.y, s.b.x, s.b.y, r);
+		mark_dirty(r);
+		budget -= segment_cost(s);
+		m_segments.pop_front();
+	}
+	//Сетка и отрисовка обновляются блоками один раз за квант, только по нарисованному
+	flush_dirty();
+
+	//Система живёт, пока не нарисован последний отрезок
+	if(nstops == m_clefts.size())
+		m_bStopped = 1;
+	return !m_bStopped || !m_segments.empty();
+}
+
+void CTerraCleftSystem::mark_dirty(const sRect& r)
+{
+	int bx = vMap.H_SIZE >> kmGridChA;
+	int by = vMap.V_SIZE >> kmGridChA;
+	if(m_dirty.size() != bx*by)
+		m_dirty.assign(bx*by, 0);
+
+	int x0 = r.left >> kmGridChA, x1 = r.right >> kmGridChA;
+	int y0 = r.top >> kmGridChA, y1 = r.bottom >> kmGridChA;
+	for(int y = y0; ; y = (y + 1) & (by - 1))
+	{
+		for(int x = x0; ; x = (x + 1) & (bx - 1))
+		{
+			m_dirty[y*bx + x] = 1;
+			if(x == x1)
+				break;
+		}
+		if(y == y1)
+			break;
+	}
+}
+
+void CTerraCleftSystem::flush_dirty()
+{
+	if(m_dirty.empty())
+		return;
+
+	int bx = vMap.H_SIZE >> kmGridChA;
+	int by = vMap.V_SIZE >> kmGridChA;
+	for(int y = 0; y < by; y++)
+	{
+		unsigned char* row = &m_dirty[y*bx];
+		int x = 0;
+		while(x < bx)
+		{
+			if(!row[x])
+			{
+				x++;
+				continue;
+			}
+			int x1 = x;
+			while(x1 + 1 < bx && row[x1 + 1])
+				x1++;
+			memset(row + x, 0, x1 - x + 1);
+
+			int xl = x << kmGridChA, yt = y << kmGridChA;
+			int xr = ((x1 + 1) << kmGridChA) - 1, yb = ((y + 1) << kmGridChA) - 1;
+			vMap.recalcArea2Grid(xl, yt, xr, yb);
+			vMap.regRender(xl, yt, xr, yb);
+			x = x1 + 1;
+		}
+	}
 }
 
 #define PUSH(id) {if((b = find_node(id))){m_clefts.push_back(CTerraCleft(*a, *b));}}
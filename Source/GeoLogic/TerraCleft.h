@@ -12,6 +12,8 @@
 #include "xmath.h"
 #include <map>
 #include <list>
+#include <deque>
+#include <vector>
 
 enum
 {
@@ -33,6 +35,14 @@ class CTerraCleft
 	int    width;
 public:
 
+	//Отрезок трещины, рисуется системой после обхода трещин за квант
+	struct Segment
+	{
+		Vect2i a, b;
+		int    width; //0 - сглаженная линия LineAA, иначе geoLine такой ширины
+	};
+	typedef std::deque<Segment> SegmentList;
+
 	typedef std::list<CTerraCleft*> SiblingList;
 	SiblingList m_siblings;
 	int processing;
@@ -42,8 +52,8 @@ public:
 	CTerraCleft(const Vect2i& pos1, const Vect2i& pos2, int active = prcWait);
 	~CTerraCleft();
 
-	int  quant(sRect& r);
-	int  quant_g(sRect& r);
+	int  quant(SegmentList& segments);
+	int  quant_g(SegmentList& segments);
 
 	CTerraCleft& attach(CTerraCleft& cleft);
 	Vect2i& to(){
@@ -72,6 +82,13 @@ class CTerraCleftSystem
 	NodeMap       m_nodes;
 	CleftList     m_clefts;
 
+	//Отрезки в порядке появления, ждущие отрисовки; за квант рисуется не больше бюджета
+	CTerraCleft::SegmentList  m_segments;
+	std::vector<unsigned char> m_dirty; //Блоки kmGridChA, ждущие пересчёта сетки и перерисовки
+	int m_bStopped; //Все трещины остановились, осталось дорисовать m_segments
+
+	void mark_dirty(const sRect& r);
+	void flush_dirty();
 
 	Vect2i* find_node(int id);
 	void init_radial(const Vect2i& pos1);
@@ -325,6 +325,9 @@ void HTManager::ClearDeleteUnit(bool delete_all)
 
 		itd=DeleteList.erase(DeleteList.begin());
 	}
+
+	if(delete_all)
+		UnitPool::releaseUnused();
 }
 
 float HTManager::GetLogicFps()
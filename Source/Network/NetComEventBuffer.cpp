@@ -67,19 +67,32 @@ void InOutNetComBuffer::putNetCommand(const netCommandGeneral* event)
 	write(&size_of_event, sizeof(size_of_event));
 	set(off);
 	filled_size=off;
-	set(0);
+	set(next_event_pointer);
 	//для нормального next event
 	event_ID = NETCOM_ID_NONE;
 }
 
 //in
-void InOutNetComBuffer::clearBufferOfTheProcessedCommands() {
-	if(next_event_pointer){
-		if(filled_size != next_event_pointer)
-			memmove(address(),address() + next_event_pointer, filled_size - next_event_pointer);
-		filled_size -= next_event_pointer;
-		offset = next_event_pointer = 0;
+//Прочитанные команды не сдвигаются на каждом put, непрочитанный хвост переносится в начало
+//только когда прочитанная часть больше половины буфера (или force), так что каждый байт
+//в среднем копируется не больше одного раза
+void InOutNetComBuffer::clearBufferOfTheProcessedCommands(bool force) {
+	//Пока команда читается, её заголовок ещё может понадобиться backNetCommand
+	if(event_ID != NETCOM_ID_NONE)
+		return;
+	size_t processed = std::min(offset, next_event_pointer);
+	if(!processed)
+		return;
+	if(processed == filled_size){
+		filled_size = offset = next_event_pointer = 0;
+		return;
 	}
+	if(!force && processed * 2 <= length())
+		return;
+	memmove(address(), address() + processed, filled_size - processed);
+	filled_size -= processed;
+	offset -= processed;
+	next_event_pointer -= processed;
 }
 
 bool InOutNetComBuffer::putBufferPacket(char* buf, unsigned int size)
@@ -97,9 +110,15 @@ bool InOutNetComBuffer::putBufferPacket(char* buf, unsigned int size)
     }
 	clearBufferOfTheProcessedCommands();
 	if(length()-filled_size < size) {
-        fprintf(stderr, "Net input buffer is small\n");
-        xassert(0);
-		return false;
+		clearBufferOfTheProcessedCommands(true);
+	}
+	if(length()-filled_size < size) {
+		if(!automatic_realloc) {
+			fprintf(stderr, "Net input buffer is small\n");
+			xassert(0);
+			return false;
+		}
+		realloc(std::max(length() * 2, filled_size + size));
 	}
 	memcpy(address() + filled_size, buf, size);
 	byte_receive+=size;
@@ -191,13 +210,13 @@ size_t InOutNetComBuffer::getQuantAmount()
 		if(event_ID==NETCOM_ID_NEXT_QUANT) cntQuant++;
 		i=next_event_pointer;
 	}
-	while(i<filled_size){
-		sizeCurEvent=*(event_size_t*)(&buf[i]);
+	while(i + SIZE_NETCOM_PACKET_HEAD <= filled_size){
+		i+=sizeof(NETCOM_BUFFER_PACKET_ID);
+		memcpy(&sizeCurEvent, &buf[i], sizeof(sizeCurEvent));
 		i+=sizeof(event_size_t);
-		curID=*(terEventID*)(&buf[i]);
+		memcpy(&curID, &buf[i], sizeof(curID));
 		if(curID==NETCOM_ID_NEXT_QUANT) cntQuant++;
 		i+=sizeCurEvent;
-
 	}
 	return cntQuant;
 }
@@ -21,7 +21,7 @@ public:
 	InOutNetComBuffer(unsigned int size, bool autoRealloc);
     InOutNetComBuffer(void* p, size_t sz);
 
-	void clearBufferOfTheProcessedCommands(void);//out
+	void clearBufferOfTheProcessedCommands(bool force = false);//out
     int send(PNetCenter& conn, NETID netid);//out
 	void reset();//?
     void reset_stats() {
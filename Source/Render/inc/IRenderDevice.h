@@ -133,6 +133,18 @@ struct sDataRenderMaterial
     sDataRenderMaterial() = default;
 };
 
+//Per frame counters of command submission, filled by devices that record command lists
+struct sRenderFrameStats
+{
+    uint32_t commands = 0;          //recorded draw commands
+    uint32_t sorted_commands = 0;   //commands inside runs sorted by state key
+    uint32_t merged_commands = 0;   //commands folded into previous command
+    uint32_t draw_calls = 0;
+    uint32_t pipeline_binds = 0;
+    uint32_t binding_applies = 0;
+    uint32_t batched_meshes = 0;    //meshes written into shared buffer instead of own command
+};
+
 using ColorConversionFunc = uint32_t (*)(const sColor4c&);
 
 class cInterfaceRenderDevice : public cUnknownClass
@@ -152,6 +164,11 @@ protected:
     Mat4f orthoVP;
     eCullMode CameraCullMode = CULL_NONE;
     bool debugUIEnabled = false;
+    sRenderFrameStats FrameStats;
+
+    //Small meshes are written pretransformed into shared buffer, so same material goes as one command
+    uint32_t batchedMeshes = 0;
+    bool BatchNoMaterialMesh(class cObjMesh* mesh, sDataRenderMaterial* data);
 
     virtual void DrawFieldDispatcher(class FieldDispatcher* ffd, uint8_t transparent);
 
@@ -171,6 +188,16 @@ public:
 
     inline eModeRenderDevice GetRenderMode() { return static_cast<eModeRenderDevice>(RenderMode); }
 
+    //Counters of last rendered frame
+    inline const sRenderFrameStats& GetFrameStats() const { return FrameStats; }
+
+    //Draws count copies of a small mesh without material, they must end up as one command
+    //Only headless device records commands without a scene, so only there is checked
+    bool CheckMeshBatching(int count);
+
+    //Changed tilemap tiles must be spread over frames by upload budget without starving any tile
+    static bool CheckTileUpdateBudget();
+
     cTexture* GetTexture(int n);
     
     void DrawFieldDispatcher(class FieldDispatcher *ffd);
@@ -2,6 +2,7 @@
 
 #include "../PluginMAX/Src/BaseClass.h"
 #include "IVisGenericInternal.h"
+#include "../src/util.h"
 #include "../src/Scene.h"
 
 #include "../src/ObjLibrary.h"
@@ -36,6 +36,15 @@ struct SokolCommand {
     size_t fs_params_len = 0;
     Vect2i* viewport = nullptr; //0 Pos 1 Size
     Vect2i* clip = nullptr; //0 Pos 1 Size
+    //Packed blend, pipeline, textures and buffers, commands with same key share most of binds
+    uint64_t sort_key = 0;
+    //Opaque with depth write, so order inside pass doesn't change result
+    bool sortable = false;
+};
+
+struct SokolCommandSortItem {
+    uint64_t key;
+    SokolCommand* command;
 };
 
 struct SokolRenderTarget final {
@@ -217,6 +226,11 @@ private:
     //Does actual drawing using sokol API
     void DoSokolRendering();
     void ProcessRenderPass(sg_pass& render_pass, const std::vector<SokolCommand*>& commands);
+    //Sorts runs of sortable commands and merges consecutive ones with same state
+    void PreparePassCommands(const std::vector<SokolCommand*>& commands, std::vector<SokolCommand*>& prepared);
+    std::vector<SokolCommand*> preparedCommands;
+    std::vector<SokolCommandSortItem> sortItems;
+    std::vector<SokolCommandSortItem> sortScratch;
 
     //Set common VS/FS parameters
     template<typename T_VS, typename T_FS>
@@ -79,7 +79,8 @@ void cSokolRender::BeginDrawMesh(bool obj_mesh, bool use_shadow_) {
 }
 
 void cSokolRender::EndDrawMesh() {
-    //TODO
+    //Submit meshes collected in shared buffer
+    FinishActiveDrawBuffer();
 }
 
 void cSokolRender::SetSimplyMaterialMesh(cObjMesh* mesh, sDataRenderMaterial* data) {
@@ -146,6 +147,12 @@ void cSokolRender::SetSimplyMaterialMesh(cObjMesh* mesh, sDataRenderMaterial* da
 void cSokolRender::DrawNoMaterialMesh(cObjMesh* mesh, sDataRenderMaterial* data) {
     //TODO SetPointLight(mesh->GetRootNode()->GetLight());
 
+    if (BatchNoMaterialMesh(mesh, data)) {
+        return;
+    }
+
+    //Previous meshes in shared buffer must go with their own texture matrices
+    FinishActiveDrawBuffer();
     SetWorldMatXf(mesh->GetGlobalMatrix());
     Mat4f& tex0mat = activeTextureTransform[0];
     if(data->mat&MAT_TEXMATRIX_STAGE1) {
@@ -110,6 +110,10 @@ void cSokolRender::DoSokolRendering() {
         simgui_new_frame(&frame_desc);
     }
 
+    FrameStats = {};
+    FrameStats.batched_meshes = batchedMeshes;
+    batchedMeshes = 0;
+
     for (auto& target : { shadowMapRenderTarget, lightMapRenderTarget }) {
         if (target != nullptr) {
             ProcessRenderPass(target->render_pass, target->commands);
@@ -133,8 +137,96 @@ void cSokolRender::DoSokolRendering() {
     ProcessRenderPass(swapchain_pass, swapchainCommands);
 }
 
+//Stable LSD radix sort by 8 bits, bytes which are same in all keys are skipped
+static void sokol_radix_sort(std::vector<SokolCommandSortItem>& items, std::vector<SokolCommandSortItem>& scratch) {
+    scratch.resize(items.size());
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t counts[256] = {};
+        for (const SokolCommandSortItem& item : items) {
+            counts[(item.key >> shift) & 0xFF]++;
+        }
+        if (counts[(items[0].key >> shift) & 0xFF] == items.size()) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t& count : counts) {
+            size_t amount = count;
+            count = offset;
+            offset += amount;
+        }
+        for (const SokolCommandSortItem& item : items) {
+            scratch[counts[(item.key >> shift) & 0xFF]++] = item;
+        }
+        items.swap(scratch);
+    }
+}
+
+static bool sokol_command_changes_pass_state(const SokolCommand* command) {
+    return command->pass_action || command->viewport || command->clip;
+}
+
+static bool sokol_commands_mergeable(const SokolCommand* prev, const SokolCommand* command) {
+    return !sokol_command_changes_pass_state(command)
+        && 3 <= prev->vertices && 3 <= command->vertices
+        && prev->pipeline == command->pipeline
+        && prev->pipeline->context.primitive_type == PT_TRIANGLES
+        && prev->vertex_buffer == command->vertex_buffer
+        && prev->index_buffer == command->index_buffer
+        && prev->base_elements + prev->indices == command->base_elements
+        && 0 == memcmp(prev->sokol_images, command->sokol_images, sizeof(SokolResourceImage*) * PERIMETER_SOKOL_TEXTURES)
+        && prev->vs_params_len == command->vs_params_len
+        && prev->fs_params_len == command->fs_params_len
+        && (0 == command->vs_params_len || 0 == memcmp(prev->vs_params, command->vs_params, command->vs_params_len))
+        && (0 == command->fs_params_len || 0 == memcmp(prev->fs_params, command->fs_params, command->fs_params_len));
+}
+
+void cSokolRender::PreparePassCommands(const std::vector<SokolCommand*>& pass_commands, std::vector<SokolCommand*>& prepared) {
+    prepared.clear();
+    FrameStats.commands += static_cast<uint32_t>(pass_commands.size());
+
+    auto append = [this, &prepared](SokolCommand* command) {
+        if (!prepared.empty() && sokol_commands_mergeable(prepared.back(), command)) {
+            //Ranges are contiguous in same buffers, draw both at once
+            SokolCommand* prev = prepared.back();
+            prev->indices += command->indices;
+            prev->vertices = std::max(prev->vertices, command->vertices);
+            FrameStats.merged_commands++;
+        } else {
+            prepared.emplace_back(command);
+        }
+    };
+
+    size_t i = 0;
+    while (i < pass_commands.size()) {
+        //Commands changing pass, viewport or clip are kept in place and break sortable runs
+        size_t end = i;
+        while (end < pass_commands.size() && pass_commands[end]->sortable
+               && !sokol_command_changes_pass_state(pass_commands[end])) {
+            end++;
+        }
+        if (end - i < 2) {
+            append(pass_commands[i]);
+            i++;
+            continue;
+        }
+
+        sortItems.clear();
+        for (size_t j = i; j < end; ++j) {
+            sortItems.push_back({ pass_commands[j]->sort_key, pass_commands[j] });
+        }
+        sokol_radix_sort(sortItems, sortScratch);
+        for (const SokolCommandSortItem& item : sortItems) {
+            append(item.command);
+        }
+        FrameStats.sorted_commands += static_cast<uint32_t>(end - i);
+        i = end;
+    }
+}
+
 #define CMDS_COMPARE_PREV_COMMAND
 void cSokolRender::ProcessRenderPass(sg_pass& render_pass, const std::vector<SokolCommand*>& pass_commands) {
+    PreparePassCommands(pass_commands, preparedCommands);
+
     std::string pass_group_label = "pass_";
     pass_group_label += render_pass.label;
     sg_push_debug_group(pass_group_label.c_str());
@@ -152,11 +244,8 @@ void cSokolRender::ProcessRenderPass(sg_pass& render_pass, const std::vector<Sok
 #endif
     const SokolCommand* command = nullptr;
     bool open_debug_group = false;
-    for (size_t passcmd_i = 0; passcmd_i < pass_commands.size(); ++passcmd_i) {
-#ifdef CMDS_COMPARE_PREV_COMMAND
-        prev_command = command;
-#endif
-        command = pass_commands[passcmd_i];
+    for (size_t passcmd_i = 0; passcmd_i < preparedCommands.size(); ++passcmd_i) {
+        command = preparedCommands[passcmd_i];
 
         //Make/Close debug group
         if (debugUIEnabled) {
@@ -176,6 +265,10 @@ void cSokolRender::ProcessRenderPass(sg_pass& render_pass, const std::vector<Sok
             sg_end_pass();
             memcpy(&render_pass.action, command->pass_action, sizeof(sg_pass_action));
             sg_begin_pass(&render_pass);
+#ifdef CMDS_COMPARE_PREV_COMMAND
+            //New pass has no state applied
+            prev_command = nullptr;
+#endif
         }
 
         //Nothing to draw
@@ -270,12 +363,18 @@ void cSokolRender::ProcessRenderPass(sg_pass& render_pass, const std::vector<Sok
                     break;
             }
 
-            //Apply pipeline
-            if (sg_query_pipeline_state(pipeline->pipeline) != SG_RESOURCESTATE_VALID) {
-                xxassert(0, "cSokolRender::ProcessRenderPass not valid state");
-                continue;
+            //Apply pipeline, bindings can be changed without reapplying same pipeline
+#ifdef CMDS_COMPARE_PREV_COMMAND
+            if (pipeline_diff)
+#endif
+            {
+                if (sg_query_pipeline_state(pipeline->pipeline) != SG_RESOURCESTATE_VALID) {
+                    xxassert(0, "cSokolRender::ProcessRenderPass not valid state");
+                    continue;
+                }
+                sg_apply_pipeline(pipeline->pipeline);
+                FrameStats.pipeline_binds++;
             }
-            sg_apply_pipeline(pipeline->pipeline);
         
             //Apply bindings
             sg_bindings bindings = {};
@@ -328,6 +427,7 @@ void cSokolRender::ProcessRenderPass(sg_pass& render_pass, const std::vector<Sok
                 bindings.fs.images[fs_slot] = image->res;
             }
             sg_apply_bindings(&bindings);
+            FrameStats.binding_applies++;
             
             //Apply VS uniforms
 #ifdef CMDS_COMPARE_PREV_COMMAND
@@ -356,6 +456,11 @@ void cSokolRender::ProcessRenderPass(sg_pass& render_pass, const std::vector<Sok
 
         //Draw
         sg_draw(static_cast<int>(command->base_elements), static_cast<int>(command->indices), 1);
+        FrameStats.draw_calls++;
+#ifdef CMDS_COMPARE_PREV_COMMAND
+        //Only drawn commands have their state applied
+        prev_command = command;
+#endif
     }
     
     if (open_debug_group) {
@@ -869,6 +974,22 @@ void cSokolRender::CreateCommand(VertexBuffer* vb, size_t vertices, IndexBuffer*
     ib->sg->buffer->IncRef();
     cmd->vertex_buffer = vb->sg->buffer;
     cmd->index_buffer = ib->sg->buffer;
+
+    //Sort key, blend and pipeline go first as most expensive to switch, then textures and buffers
+    const SokolPipelineMode& mode = pipeline_context.pipeline_mode;
+    cmd->sortable = (mode.blend == ALPHA_NONE || mode.blend == ALPHA_TEST)
+                    && mode.depth_write && mode.depth_cmp != CMP_ALWAYS;
+    uint64_t sort_key = static_cast<uint64_t>(mode.blend & 0x7) << 61;
+    sort_key |= static_cast<uint64_t>(pipeline->pipeline.id & 0xFF) << 53;
+    if (cmd->sokol_images[0]) {
+        sort_key |= static_cast<uint64_t>(cmd->sokol_images[0]->res.id & 0xFFFF) << 37;
+    }
+    if (cmd->sokol_images[1]) {
+        sort_key |= static_cast<uint64_t>(cmd->sokol_images[1]->res.id & 0x1FFF) << 24;
+    }
+    sort_key |= static_cast<uint64_t>(cmd->vertex_buffer->res.id & 0xFFFF) << 8;
+    sort_key |= static_cast<uint64_t>(cmd->index_buffer->res.id & 0xFF);
+    cmd->sort_key = sort_key;
     activeCommand.base_elements = 0;
     activeCommand.vertices = 0;
     activeCommand.indices = 0;
@@ -6,6 +6,10 @@ class cEmptyRender : public cInterfaceRenderDevice
 {
 protected:
     void DrawFieldDispatcher(class FieldDispatcher *ffd, uint8_t transparent) override { }
+
+    //Commands that would be sent since last Flush, reported in FrameStats
+    uint32_t recordedCommands = 0;
+    void FinishActiveDrawBuffer();
     
 public:
     cEmptyRender() = default;
@@ -24,7 +28,7 @@ public:
 
     int Fill(int r,int g,int b,int a=255) override { return -1; }
     void ClearZBuffer() override {};
-    int Flush(bool wnd=false) override { return -1; }
+    int Flush(bool wnd=false) override;
     int SetGamma(float fGamma,float fStart=0.f,float fFinish=1.f) override { return -1; }
 
     void DrawLine(int x1,int y1,int x2,int y2,const sColor4c& color, float width) override { }
@@ -85,13 +89,14 @@ public:
     void SetNoMaterial(eBlendMode blend,float Phase=0,cTexture *Texture0=0,cTexture *Texture1=0,eColorMode color_mode=COLOR_MOD) override {}
     void SetBlendState(eBlendMode blend) override {}
 
-    void SubmitDrawBuffer(class DrawBuffer* db, DrawRange* range) override {}
+    void SetActiveDrawBuffer(class DrawBuffer* db) override;
+    void SubmitDrawBuffer(class DrawBuffer* db, DrawRange* range) override;
     void SubmitBuffers(ePrimitiveType primitive, class VertexBuffer* vb, size_t vertices, class IndexBuffer* ib, size_t indices, DrawRange* range) override {}
 
     void BeginDrawMesh(bool obj_mesh, bool use_shadow) override {}
-    void EndDrawMesh() override {}
+    void EndDrawMesh() override;
     void SetSimplyMaterialMesh(cObjMesh* mesh, sDataRenderMaterial* data) override {}
-    void DrawNoMaterialMesh(cObjMesh* mesh, sDataRenderMaterial* data) override {}
+    void DrawNoMaterialMesh(cObjMesh* mesh, sDataRenderMaterial* data) override;
 
     void BeginDrawShadow(bool shadow_map) override {}
     void EndDrawShadow() override {}
@@ -388,6 +388,7 @@ bool cFontInternal::Create(const std::string& root_dir, const std::string& local
 		return false;
 	}
 
+	BuildGlyphs();
 	return true;
 }
 
@@ -397,3 +398,78 @@ bool cFontInternal::Reload(const char* root_dir)
 	std::string f=font_name;
 	return Create(root_dir,l,f,GetStatementHeight());
 }
+
+void cFontInternal::BuildGlyphs()
+{
+	layouts.clear();
+	Glyph.resize(Font.size());
+	float width=pTexture?static_cast<float>(pTexture->GetWidth()):1.0f;
+	for(int i=0;i<Font.size();i++)
+	{
+		sFontGlyph& g=Glyph[i];
+		g.u=Font[i].x;
+		g.v=Font[i].y;
+		g.du=Font[i].z;
+		g.width=Font[i].z*width;
+	}
+}
+
+//Строки интерфейса почти не меняются от кадра к кадру, кеш сбрасывается целиком при переполнении
+static const size_t FONT_LAYOUT_CACHE_MAX=256;
+
+const sFontLayout& cFontInternal::GetLayout(const char* string, float scale, const sColor4c& color)
+{
+	sColor4c diffuse(color.r,color.g,color.b,0);
+
+	//FNV-1a
+	uint64_t key=14695981039346656037ull;
+	for(const char* p=string;*p;p++)
+		key=(key^static_cast<uint8_t>(*p))*1099511628211ull;
+	uint32_t scale_bits;
+	memcpy(&scale_bits,&scale,sizeof(scale_bits));
+	key=(key^scale_bits)*1099511628211ull;
+	key=(key^diffuse.v)*1099511628211ull;
+
+	auto it=layouts.find(key);
+	if(it!=layouts.end())
+	{
+		sFontLayout& layout=it->second;
+		if(layout.scale==scale && layout.color==diffuse.v && layout.text==string)
+			return layout;
+	}else if(FONT_LAYOUT_CACHE_MAX<=layouts.size())
+		layouts.clear();
+
+	sFontLayout& layout=layouts[key];
+	layout.text=string;
+	layout.scale=scale;
+	layout.color=diffuse.v;
+	layout.glyphs.clear();
+	layout.lines.clear();
+
+	for(const char* str=string;*str;str++)
+	{
+		sFontLayoutLine line;
+		line.first=layout.glyphs.size();
+		float x=0;
+		for(;*str!=10;str++)
+		{
+			gb_RenderDevice->ChangeTextColor(str,diffuse);
+			uint8_t c=*str;
+			if(!c || c==10) break;
+			if(c<32 || Glyph.size()<=c) continue;
+
+			sFontLayoutGlyph g;
+			g.x0=x;
+			x+=scale*Glyph[c].width-1;
+			g.x1=x;
+			g.c=c;
+			g.color=diffuse;
+			layout.glyphs.push_back(g);
+		}
+		line.width=x;
+		line.count=layout.glyphs.size()-line.first;
+		layout.lines.push_back(line);
+		if(*str==0) break;
+	}
+	return layout;
+}
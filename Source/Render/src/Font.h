@@ -2,6 +2,35 @@
 #define _FONT_H_
 #pragma once
 
+struct sFontGlyph
+{
+	float u,v,du;	//положение в текстуре
+	float width;	//ширина в пикселях текстуры
+};
+
+//Раскладка строки для OutText, x в пикселях от начала строки
+struct sFontLayoutGlyph
+{
+	float x0,x1;
+	uint8_t c;
+	sColor4c color;//с учётом &RRGGBB, альфа берётся при выводе
+};
+
+struct sFontLayoutLine
+{
+	float width;
+	int first,count;
+};
+
+struct sFontLayout
+{
+	std::string text;
+	float scale;
+	uint32_t color;
+	std::vector<sFontLayoutGlyph> glyphs;
+	std::vector<sFontLayoutLine> lines;
+};
+
 class cFontInternal : public cUnknownClass
 {
 public:
@@ -17,15 +46,22 @@ public:
 	bool Reload(const char* root_dir);
 
 	std::vector<Vect3f>		Font; // x,y - position, z - font width
+	std::vector<sFontGlyph>	Glyph; // Font в пикселях, заполняется после создания текстуры
 	float				FontHeight;
 
+	//Раскладка кешируется по тексту, масштабу и начальному цвету
+	const sFontLayout& GetLayout(const char* string, float scale, const sColor4c& color);
+
 	std::string font_name;
     std::string locale;
 	int GetStatementHeight() const {return statement_height;};
 protected:
 	int statement_height;
 	cTexture* pTexture;
+	std::unordered_map<uint64_t,sFontLayout> layouts;
 	friend class cFont;
+
+	void BuildGlyphs();
 	
 	bool CreateTexture(const char* fontname, const char* fname, int height);
 	bool CreateImage(const char* filename, const char* fontname, int height, class cFontImage* image);
@@ -46,6 +46,10 @@ public:
 protected:
 	virtual void SetPosition(const MatXf& Matrix);
 	virtual int SetChannel(const char *NameChainMask,float phase_);
+	int FindChannel(const char *NameChainMask);
+	int SetChannel(int nChannel,float phase_);
+	//Только локальная матрица и видимость, без пересчёта глобальной
+	int SampleChannel(int nChannel,float phase_);
 	virtual void Draw(cCamera *UCamera);
 	inline void SetNameObj(const char *Name)
 	{
@@ -93,6 +97,11 @@ void cLogicTileInt::SetPosition(const MatXf& Matrix)
 	VISASSERT(0);
 }
 int cLogicTileInt::SetChannel(const char *NameChainMask,float phase_)
+{
+	return SetChannel(FindChannel(NameChainMask),phase_);
+}
+
+int cLogicTileInt::FindChannel(const char *NameChainMask)
 {
 	int number=AnimChannel->GetNumberChannel();
 	int i;
@@ -103,13 +112,26 @@ int cLogicTileInt::SetChannel(const char *NameChainMask,float phase_)
 	//xassert_s(i < AnimChannel->GetNumberChannel() && "Animation chain not found", NameChainMask);
 	
 	if(i>=number) return -2;
+	return i;
+}
+
+int cLogicTileInt::SetChannel(int i,float phase_)
+{
+	if(i<0) return -2;
+	SampleChannel(i,phase_);
+	UpdatePosition();
+	
+	return i;
+}
+
+int cLogicTileInt::SampleChannel(int i,float phase_)
+{
+	if(i<0) return -2;
 	//phase_=fmod(phase_+FRAME_PHASE_RANGE,FRAME_PHASE_RANGE); // анимироваться
 	xassert(phase_>=0 && phase_<=1.0001);
 	cAnimChainNode* anim=AnimChannel->GetChannel(i);
 	anim->GetMatrix(phase_,LocalMatrix);
 	anim->GetVisible(phase_,visible);
-	UpdatePosition();
-	
 	return i;
 }
 int cLogicTileInt::GetAnimation(MatXf *Matrix,int *Visible) 
@@ -477,6 +499,9 @@ cLogicGeneric* CreateILogicGeneric()
 cLogicObject::cLogicObject(const char *fname_):cIUnkObjScale(KIND_LOGIC_OBJ)
 {
 	fname=fname_;
+	last_channel_table=-1;
+	last_channel_phase=0;
+	last_channel_result=-2;
 }
 cLogicObject::~cLogicObject()
 {
@@ -517,16 +542,11 @@ void cLogicObject::GetBoundBox(sBox6f& Box)
 
 cLogicTile* cLogicObject::FindObject(const char *name)
 {
-	vtiles::iterator it;
-	FOR_EACH(tiles,it)
-	{
-		const char* tile_name=(*it)->GetNameObj();
-		if(tile_name && name && stricmp(tile_name,name)==0)
-			return *it;
-		if(tile_name==NULL && name==NULL)
-			return *it;
-	}
-	return NULL;
+	//Имя тайла не бывает NULL
+	if(!name)
+		return NULL;
+	int i=tile_names.Find(name,[this](int i){ return tiles[i]->GetNameObj(); });
+	return i>=0 ? tiles[i] : NULL;
 }
 
 void cLogicObject::SetPosition(const MatXf& Matrix)
@@ -537,32 +557,76 @@ void cLogicObject::SetPosition(const MatXf& Matrix)
 	Update();
 }
 
-void cLogicObject::Update()
+void cLogicObject::BuildUpdateOrder()
 {
+	update_order.clear();
 	vtiles::iterator it;
 	FOR_EACH(tiles,it)
-	{
-		cLogicTileInt* p=*it;
-		if(p->Parent==this)
-			p->UpdatePosition();
-	}
+		if((*it)->Parent==this)
+			update_order.push_back(*it);
 
 	FOR_EACH(tiles,it)
-	{
-		cLogicTileInt* p=*it;
-		if(p->Parent!=this)
-			p->UpdatePosition();
-	}
+		if((*it)->Parent!=this)
+			update_order.push_back(*it);
 }
 
-int cLogicObject::SetChannel(const char *NameChainMask,float phase_)
-{ 
+void cLogicObject::Update()
+{
+	if(update_order.size()!=tiles.size())
+		BuildUpdateOrder();
+
+	std::vector<cLogicTileInt*>::iterator it;
+	FOR_EACH(update_order,it)
+		(*it)->UpdatePosition();
+}
+
+int cLogicObject::GetChannelTable(const char *NameChain)
+{
+	for(int i=0;i<channel_tables.size();i++)
+		if(stricmp(channel_tables[i].name.c_str(),NameChain)==0)
+			return i;
+
+	channel_tables.push_back(sChannelTable());
+	sChannelTable& table=channel_tables.back();
+	table.name=NameChain;
+	table.tile_channel.resize(tiles.size());
+	for(int i=0;i<tiles.size();i++)
+		table.tile_channel[i]=tiles[i]->FindChannel(NameChain);
+	return channel_tables.size()-1;
+}
+
+bool cLogicObject::SampleChannel(const char *NameChainMask,float phase_)
+{
 	xassert(phase_>=0 && phase_<=1.00001);
+	int table_index=GetChannelTable(NameChainMask);
+	if(table_index==last_channel_table && phase_==last_channel_phase)
+		return false;
+
+	const sChannelTable& table=channel_tables[table_index];
 	int ret=-2;
-	vtiles::iterator it;
-	FOR_EACH(tiles,it)
-		ret=(*it)->SetChannel(NameChainMask,phase_);
-	return ret;
+	for(int i=0;i<tiles.size();i++)
+		ret=tiles[i]->SampleChannel(table.tile_channel[i],phase_);
+
+	last_channel_table=table_index;
+	last_channel_phase=phase_;
+	last_channel_result=ret;
+	return true;
+}
+
+int cLogicObject::SetChannel(const char *NameChainMask,float phase_)
+{ 
+	//Сначала все локальные матрицы, потом один проход по иерархии.
+	//Если локальные не менялись, глобальные уже посчитаны в прошлый раз
+	if(SampleChannel(NameChainMask,phase_))
+		Update();
+	return last_channel_result;
+}
+
+int cLogicObject::SetChannelPosition(const char *NameChainMask,float phase_,const MatXf& Matrix)
+{
+	SampleChannel(NameChainMask,phase_);
+	SetPosition(Matrix);
+	return last_channel_result;
 }
 void cLogicObject::Draw(cCamera *UCamera)
 {
@@ -586,7 +650,11 @@ void cLogicObject::Attach(cLogicTileInt* p)
 		p->Parent=this;
 		p->broot=true;
 	}
+	tile_names.Add(p->GetNameObj(),tiles.size());
 	tiles.push_back(p);
+	channel_tables.clear();
+	last_channel_table=-1;
+	update_order.clear();
 }
 
 cIUnkClass* cLogicObject::NextObject(cIUnkClass *UObj)
@@ -623,24 +691,26 @@ void cLogicObject::SetCopy(cIUnkObj* UObj)
 {
 	cIUnkObjScale::SetCopy(UObj);
 	cLogicObject* logic=(cLogicObject*)UObj;
-	vtiles::iterator it;
-	FOR_EACH(tiles,it)
+	for(int i=0;i<tiles.size();i++)
 	{
 		cLogicTileInt *cur,*to;
-		cur=*it;
+		cur=tiles[i];
 		to=(cLogicTileInt*)cur->BuildCopy();
 		if(cur->broot)
 		{
 			to->Parent=logic;
 		}else
 		{
-			cLogicTile* parent=logic->FindObject(cur->Parent->GetName());
-			VISASSERT(parent);
-			to->Parent=parent;
+			//Тайлы копии идут в том же порядке, родитель ищется среди уже скопированных
+			int parent=tile_names.Find(cur->Parent->GetName(),[this](int i){ return tiles[i]->GetNameObj(); });
+			VISASSERT(parent>=0 && parent<i);
+			to->Parent=parent>=0 && parent<i ? logic->tiles[parent] : NULL;
 		}
 
 		logic->tiles.push_back(to);
 	}
+	logic->tile_names=tile_names;
+	logic->channel_tables=channel_tables;
 }
 
 cIUnkObj* cLogicObject::BuildCopy()
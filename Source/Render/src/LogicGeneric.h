@@ -14,6 +14,28 @@ protected:
 	typedef std::vector<cLogicTileInt*> vtiles;
 	vtiles				tiles;
 	std::string				fname;								// имя файла из которого он был загружен
+	cNameIndex			tile_names;
+
+	//Номера цепочек каждого тайла для уже встречавшихся имён цепочек,
+	//копии используют те же AnimChannel, поэтому таблицы копируются вместе с тайлами
+	struct sChannelTable
+	{
+		std::string name;
+		std::vector<int> tile_channel;//-2 - у тайла нет такой цепочки
+	};
+	std::vector<sChannelTable> channel_tables;
+	int GetChannelTable(const char *NameChain);
+
+	//Последняя выставленная цепочка, повторно с той же фазой не пересчитывается
+	int last_channel_table;
+	float last_channel_phase;
+	int last_channel_result;
+	//Выставляет локальные матрицы тайлов, false - цепочка и фаза те же, что в прошлый раз
+	bool SampleChannel(const char *NameChain,float phase);
+
+	//Порядок пересчёта матриц: сначала тайлы, прикреплённые к объекту, потом остальные
+	std::vector<cLogicTileInt*> update_order;
+	void BuildUpdateOrder();
 
 public:
 	cLogicObject(const char *fname);
@@ -26,6 +48,8 @@ public:
 	virtual cLogicTile* FindObject(const char *name);
 	virtual void SetPosition(const MatXf& Matrix);
 	virtual int SetChannel(const char *NameChain,float phase=0.0f);
+	//SetChannel и SetPosition с одним пересчётом иерархии
+	int SetChannelPosition(const char *NameChain,float phase,const MatXf& Matrix);
 	virtual void Draw(cCamera *UCamera);
 	inline const char* GetName() const							{ return fname.c_str(); }
 
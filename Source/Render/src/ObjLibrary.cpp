@@ -610,6 +610,7 @@ void cObjLibrary::FreeOne(FILE* f)
 void cObjLibrary::Compact(FILE* f)
 {
 	MTAuto mtlock(&lock);
+	element_cache.clear();
 	FreeOne(f);
 	remove_null_element(objects);
 }
@@ -617,6 +618,7 @@ void cObjLibrary::Compact(FILE* f)
 void cObjLibrary::Free(FILE* f)
 {
 	MTAuto mtlock(&lock);
+	element_cache.clear();
 	FreeOne(f);
 	objects.clear();
 }
@@ -635,6 +637,16 @@ cObjectNodeRoot* cObjLibrary::GetElementInternal(const char* pFileName,const cha
 		return NULL;
 	}
 
+	std::string cache_key = pFileName;
+	cache_key += '\n';
+	if (pTexturePath) {
+		cache_key += pTexturePath;
+	}
+	auto cached = element_cache.find(cache_key);
+	if (cached != element_cache.end()) {
+		return (cObjectNodeRoot*) cached->second->root->BuildCopy();
+	}
+
 	std::string fname;
     std::string DefPath;
     std::string TexturePath;
@@ -674,6 +686,7 @@ cObjectNodeRoot* cObjLibrary::GetElementInternal(const char* pFileName,const cha
             nearest_bank = bank;
 
             if (stricmp(bank->GetTexturePath(), TexturePath.c_str()) == 0) {
+                element_cache[cache_key] = bank;
                 cObjectNodeRoot* tmp = (cObjectNodeRoot*) bank->root->BuildCopy();
                 return tmp;
             }
@@ -704,6 +717,7 @@ cObjectNodeRoot* cObjLibrary::GetElementInternal(const char* pFileName,const cha
 		objects.push_back(ObjNode); 
 		if(ObjNodeLod)
 			objects.push_back(ObjNodeLod); 
+		element_cache[cache_key] = ObjNode;
 		tmp=(cObjectNodeRoot*)ObjNode->root->BuildCopy(); 
 	}
 	return tmp;
@@ -999,6 +1013,7 @@ cAllMeshBank* cObjLibrary::LoadM3D(const char *fname,const char *TexturePath,con
 	BaseNode->SetPosition(MatXf::ID);
 	BaseNode->Update();
 	BaseNode->BuildChild();
+	VISASSERT(BaseNode->CheckChildNames());
 	BaseNode->CalcMatrix();
 	BaseNode->CalcBorder();
 	BaseNode->CalcObj();
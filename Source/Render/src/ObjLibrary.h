@@ -19,6 +19,8 @@ public:
 private:
 	typedef std::vector<cAllMeshBank*> OBJECTS;
 	OBJECTS objects;
+	//Requested file name and texture path to loaded bank, skips path resolving and banks scan
+	std::unordered_map<std::string, cAllMeshBank*> element_cache;
 	cAllMeshBank* LoadM3D(const char *fname,const char *TexturePath,const char *DefTexturePath,bool enable_error_not_found);
 	inline int GetNumberObj()									{ return objects.size(); }
 	inline cAllMeshBank* GetObj(int number)						{ return objects[number]; }
@@ -359,44 +359,39 @@ bool cObjectNode::Intersect(const Vect3f& p0,const Vect3f& p1)
 //////////////////////////////////////////////////////////////////////////////////////////
 void cObjectNode::AttachChild(cObjectNode *child)
 {
+	if(RootNode)
+		RootNode->NodeAttribute.ClearAttribute(ATTRNODE_NAMEINDEX);
 	child->SetParent(this);
 	cBaseNode <cObjectNode>::AttachChild(child);
 }
 void cObjectNode::DetachChild(cObjectNode *child)
 {
+	if(RootNode)
+		RootNode->NodeAttribute.ClearAttribute(ATTRNODE_NAMEINDEX);
 	child->SetParent(0);
 	cBaseNode <cObjectNode>::DetachChild(child);
 }
-void cObjectNode::CalcMatrix()
-{
-	if(Parent)
-	{
-		if(AnimChannel)
-		{
-			cAnimChainNode* anim=AnimChannel->GetChannel(0);
-			anim->GetMatrix(0,LocalMatrix);
-		}
-
-		GlobalMatrix=Parent->GetGlobalMatrix()*GetLocalMatrix();
-	}else
-		GlobalMatrix=GetLocalMatrix();
-	for(cObjectNode *child=GetChild();child;child=child->GetSibling())
-		child->CalcMatrix();
-}
-
 cObjectNode* cObjectNode::FindSubObject(const char *name)
 { 
 	return FindObject(name);
 }
 
 cObjectNode* cObjectNode::FindObject(const char *name)
+{
+	//Индекс строится в BuildChild, при загрузке и после AttachChild/DetachChild ищем обходом
+	if(RootNode==this && name && NodeAttribute.GetAttribute(ATTRNODE_NAMEINDEX))
+		return static_cast<cObjectNodeRoot*>(this)->FindChildObject(name);
+	return FindObjectRecursive(name);
+}
+
+cObjectNode* cObjectNode::FindObjectRecursive(const char *name)
 {
 	if(name==NULL && GetNameObj()==NULL)
 		return this;
 	if(GetNameObj()&&stricmp(GetNameObj(),name)==0) 
 		return this;
 	for(cObjectNode *child=GetChild();child;child=child->GetSibling())
-		if(cObjectNode *UnkNode=child->FindObject(name)) 
+		if(cObjectNode *UnkNode=child->FindObjectRecursive(name)) 
 			return UnkNode;
 	return 0;
 }
@@ -478,17 +473,6 @@ void cObjectNode::SetGroup(int& cur_num, std::vector<cObjectGroup>& groups,cObje
 		child->SetGroup(cur_num,groups,group);
 }
 
-void cObjectNode::UpdateMatrix()
-{
-	cAnimChainNode* anim=AnimChannel->GetChannel(GetCurrentChannel());
-
-	if(anim->IsAnimMatrix())
-		anim->GetMatrix(GetPhase(),LocalMatrix);
-	GlobalMatrix.mult(GetParentNode()->GetGlobalMatrix(),GetLocalMatrix());
-	if(NodeAttribute.GetAttribute(ATTRNODE_ENABLEROTATEMATRIX))
-		GlobalMatrix.rot()*=RotateMatrix;
-}	
-
 void cObjectNode::AddShadow(MatXf mat,cMeshTri* Tri)
 {
 	if (!(gb_RenderDevice->GetRenderMode()&RENDERDEVICE_MODE_STRENCIL)) {
@@ -693,6 +677,11 @@ void cObjectNodeRoot::PreDraw(cCamera *DrawNode)
 	if(!DrawNode->TestVisible(GetGlobalMatrix(),GlobalBound.min,GlobalBound.max) )
 		return;
 
+	PreDrawVisible(DrawNode);
+}
+
+void cObjectNodeRoot::PreDrawVisible(cCamera *DrawNode)
+{
 	DrawNode->AttachTestShadow(this);
 	Update();
 
@@ -758,6 +747,27 @@ void cObjectNodeRoot::BuildChild()
 	mesh_child.clear();
 	light_child.clear();
 	AddChild(all_child);
+
+	int n=all_child.size();
+	child_parent.resize(n);
+	child_global.resize(n);
+	for(int i=0;i<n;i++)
+	{
+		//Родитель - ближайший предыдущий узел, между ними только его потомки
+		cObjectNode* parent=all_child[i]->GetParentNode();
+		int ip=i-1;
+		while(ip>=0 && all_child[ip]!=parent)
+			ip--;
+		VISASSERT(ip>=0 || parent==this);
+		child_parent[i]=ip;
+	}
+
+	child_names.Clear();
+	for(int i=0;i<n;i++)
+		if(const char* name=all_child[i]->GetNameObj())
+			child_names.Add(name,i);
+	NodeAttribute.SetAttribute(ATTRNODE_NAMEINDEX);
+
 	std::vector<cObjectNode*>::iterator it;
 	FOR_EACH(all_child,it)
 	{
@@ -994,15 +1004,66 @@ void cObjectNodeRoot::Update()
 {
 	if(!NodeAttribute.GetAttribute(ATTRNODE_UPDATEMATRIX))
 		return;
-	std::vector<cObjectNode*>::iterator it;
-	FOR_EACH(all_child,it)
+	int n=all_child.size();
+	for(int i=0;i<n;i++)
 	{
-		(*it)->UpdateMatrix();
+		cObjectNode* node=all_child[i];
+		cAnimChainNode* anim=node->AnimChannel->GetChannel(node->GetCurrentChannel());
+		if(anim->IsAnimMatrix())
+			anim->GetMatrix(node->GetPhase(),node->LocalMatrix);
+
+		int parent=child_parent[i];
+		MatXf& global=child_global[i];
+		global.mult(parent<0?GetGlobalMatrix():child_global[parent],node->GetLocalMatrix());
+		if(node->NodeAttribute.GetAttribute(ATTRNODE_ENABLEROTATEMATRIX))
+			global.rot()*=node->RotateMatrix;
+		node->GlobalMatrix=global;
 	}
 
 	NodeAttribute.ClearAttribute(ATTRNODE_UPDATEMATRIX);
 }
 
+cObjectNode* cObjectNodeRoot::FindChildObject(const char *name)
+{
+	//Имя корня может смениться после BuildChild, поэтому проверяется напрямую
+	if(GetNameObj()&&stricmp(GetNameObj(),name)==0) 
+		return this;
+	//all_child в порядке обхода, так что первый по номеру - тот же, что нашёл бы рекурсивный поиск
+	int i=child_names.Find(name,[this](int i){ return all_child[i]->GetNameObj(); });
+	return i>=0 ? all_child[i] : NULL;
+}
+
+bool cObjectNodeRoot::CheckChildNames()
+{
+	//Индекс должен находить те же узлы, что и обход дерева
+	int n=all_child.size();
+	for(int i=0;i<n;i++)
+		if(const char* name=all_child[i]->GetNameObj())
+			if(FindObject(name)!=FindObjectRecursive(name))
+				return false;
+	return true;
+}
+
+void cObjectNodeRoot::CalcMatrix()
+{
+	GlobalMatrix=GetLocalMatrix();
+	int n=all_child.size();
+	for(int i=0;i<n;i++)
+	{
+		cObjectNode* node=all_child[i];
+		if(node->AnimChannel)
+		{
+			cAnimChainNode* anim=node->AnimChannel->GetChannel(0);
+			anim->GetMatrix(0,node->LocalMatrix);
+		}
+
+		int parent=child_parent[i];
+		MatXf& global=child_global[i];
+		global=(parent<0?GetGlobalMatrix():child_global[parent])*node->GetLocalMatrix();
+		node->GlobalMatrix=global;
+	}
+}
+
 void cObjectNodeRoot::GetAllPoints(std::vector<Vect3f>& point)
 {
 	MatXf save=GetLocalMatrix();
@@ -18,6 +18,7 @@ enum eAttributeObjectNode
 	ATTRNODE_CURFRAME_ALPHA		=	1<<5,
 	ATTRNODE_EFFECT				=	1<<6,
 	ATTRNODE_EFFECT_CYCLED		=	1<<7,
+	ATTRNODE_NAMEINDEX			=	1<<8,	// у корня индекс имён all_child соответствует дереву
 	ATTRNODE_COPYBASE			=	1<<29,
 };
 
@@ -104,8 +105,8 @@ public:
 	virtual void CalcObj();
 
 	// функции cObjectNode
-	void CalcMatrix();
 	cObjectNode* FindObject(const char *name);						// поиск группы по имени объекта в группе или имени самой группы
+	cObjectNode* FindObjectRecursive(const char *name);				// то же обходом дерева, без индекса имён
 	virtual cIUnkClass* NextObject(cIUnkClass *UObj);
 	
 	const char* GetNameObj() const;
@@ -173,7 +174,6 @@ protected:
 
 	int GetNumGroup();
 	void SetGroup(int& cur_num, std::vector<cObjectGroup>& groups,cObjectGroup* cur_group);
-	void UpdateMatrix();
 
 	virtual void AddShadow(MatXf mat,class cMeshTri* Tri);
 	virtual void BuildShadow();
@@ -217,6 +217,11 @@ protected:
 	sBound*				Base;
 	Vect3f				Scale;	// масштаб
 	std::vector<cObjectNode*> all_child;
+	//all_child идут в порядке обхода, родитель всегда раньше детей,
+	//поэтому матрицы пересчитываются одним линейным проходом
+	std::vector<int>		 child_parent;//индекс родителя в all_child, -1 - корень
+	std::vector<MatXf>		 child_global;
+	cNameIndex				 child_names;//имена all_child
 	std::vector<cObjMesh*>	 mesh_child;
 	std::vector<cObjLight*>	 light_child;
 	double			MaterialAnimTime;
@@ -243,6 +248,10 @@ public:
 	void SetPosition(const MatXf& Matrix) override;
 	void Animate(float dt) override;
 	void PreDraw(cCamera *DrawNode) override;
+	//PreDraw для объекта, видимость которого уже известна
+	void PreDrawVisible(cCamera *DrawNode);
+	inline bool HasObservers(){return !observer.empty();}
+	inline const sBox6f& GetLocalBound() const{return GlobalBound;}
 	void GetLocalBorder(int *nVertex,Vect3f **Vertex,int *nIndex,short **Index) override;
 	
 	virtual const Vect3f& GetScale() const		{ return Scale; }
@@ -275,6 +284,10 @@ public:
 	void SetAttr(int attribute) override;
 
 	void Update() override;
+	//Матрицы по нулевому кадру первой цепочки, вызывается при загрузке
+	void CalcMatrix();
+	//FindObject для корня, через индекс имён, пока он соответствует дереву
+	cObjectNode* FindChildObject(const char *name);
 
 	inline std::vector<cObjMesh*>& GetMeshChild(){return mesh_child;}
 
@@ -304,6 +317,7 @@ public:
 protected:
 	void SetCopy(cIUnkObj* UObj) override;
 	void BuildChild();
+	bool CheckChildNames();
 	void BuildGroup();
 	void PreDrawSort(cCamera *DrawNode);
 	void ClearDrawSort();
@@ -7,6 +7,10 @@
 #include "IRenderDevice.h"
 #include "EmptyRenderDevice.h"
 #include "DrawBuffer.h"
+#include "MeshTri.h"
+#include "MeshBank.h"
+#include "ObjNode.h"
+#include "ObjMesh.h"
 #include "RenderTracker.h"
 
 //Per backend includes
@@ -635,6 +639,153 @@ bool cInterfaceRenderDevice::DebugUIKeyPress(struct sKey* key, bool pressed) {
 
 // Render device selection
 
+//Meshes up to this size are cheaper to transform on CPU than to draw separately
+static const int MESH_BATCH_MAX_VERTICES = 256;
+static const int MESH_BATCH_MAX_POLYGONS = 512;
+
+bool cInterfaceRenderDevice::BatchNoMaterialMesh(cObjMesh* mesh, sDataRenderMaterial* data) {
+    cMeshTri* Tri = mesh->GetTri();
+    if (!Tri->NumVertex || !Tri->NumPolygon
+    || Tri->NumVertex > MESH_BATCH_MAX_VERTICES || Tri->NumPolygon > MESH_BATCH_MAX_POLYGONS
+    || Tri->db->vb.fmt != sVertexXYZNT1::fmt) {
+        return false;
+    }
+    //Texture matrices are per command
+    if (data->mat & (MAT_TEXMATRIX_STAGE1 | MAT_RENDER_SPHEREMAP)) {
+        return false;
+    }
+    //Specular uses position in model space, it would change after pretransform
+    if ((data->mat & MAT_LIGHT) && (data->mat & MAT_COLOR_ADD_SPECULAR)) {
+        return false;
+    }
+
+    SetWorldMatXf(MatXf::ID);
+    DrawBuffer* db = GetDrawBuffer(sVertexXYZNT1::fmt, PT_TRIANGLES);
+    sVertexXYZNT1* vertices = nullptr;
+    indices_t* indices = nullptr;
+    size_t n_indices = Tri->NumPolygon * sPolygon::PN;
+    db->Lock(Tri->NumVertex, n_indices, vertices, indices, true);
+    if (!vertices || !indices) {
+        return false;
+    }
+
+    const MatXf& mat = mesh->GetGlobalMatrix();
+    Vect3f v;
+    for (int i = 0; i < Tri->NumVertex; i++) {
+        const sVertexXYZNT1& src = Tri->VertexBuffer[i];
+        sVertexXYZNT1& dst = vertices[i];
+        v.set(src.pos);
+        mat.xformPoint(v);
+        v.write(dst.pos);
+        v.set(src.n);
+        mat.xformVect(v);
+        v.write(dst.n);
+        dst.uv[0] = src.uv[0];
+        dst.uv[1] = src.uv[1];
+    }
+
+    //Polygons index whole cMeshStatic, move them to our place in buffer
+    const indices_t* src_indices = reinterpret_cast<const indices_t*>(Tri->PolygonBuffer);
+    for (size_t i = 0; i < n_indices; i++) {
+        indices[i] = static_cast<indices_t>(src_indices[i] - Tri->OffsetVertex + db->written_vertices);
+    }
+    db->Unlock();
+    batchedMeshes++;
+    return true;
+}
+
+bool cInterfaceRenderDevice::CheckMeshBatching(int count) {
+    if (GetRenderSelection() != DEVICE_HEADLESS) {
+        return false;
+    }
+
+    //Single quad, small enough to be batched
+    std::vector<Vect3f> vertex = { Vect3f(0, 0, 0), Vect3f(1, 0, 0), Vect3f(0, 1, 0), Vect3f(1, 1, 0) };
+    std::vector<Vect3f> normal(vertex.size(), Vect3f(0, 0, 1));
+    std::vector<Vect2f> texel = { Vect2f(0, 0), Vect2f(1, 0), Vect2f(0, 1), Vect2f(1, 1) };
+    std::vector<sPolygon> polygon(2);
+    polygon[0].set(0, 1, 2);
+    polygon[1].set(2, 1, 3);
+
+    cMeshStatic* bank = new cMeshStatic("CheckMeshBatching");
+    bank->BeginBuildMesh();
+    cMeshTri* tri = bank->AddMesh(vertex, polygon, normal, texel);
+    bank->EndBuildMesh(false);
+    cObjMesh* mesh = new cObjMesh();
+    mesh->SetTri(tri);
+    sDataRenderMaterial data;
+
+    //Drop whatever was counted before
+    Flush();
+    BeginDrawMesh(true, false);
+    SetSimplyMaterialMesh(mesh, &data);
+    for (int i = 0; i < count; i++) {
+        DrawNoMaterialMesh(mesh, &data);
+    }
+    EndDrawMesh();
+    Flush();
+
+    bool ok = FrameStats.commands == 1 && FrameStats.batched_meshes == static_cast<uint32_t>(count);
+    printf("CheckMeshBatching: %d meshes, %u commands, %u batched\n",
+           count, FrameStats.commands, FrameStats.batched_meshes);
+
+    mesh->Release();
+    bank->Release();
+    return ok;
+}
+
+//Headless device records no commands, it only counts them like sokol would
+
+void cEmptyRender::FinishActiveDrawBuffer() {
+    if (!activeDrawBuffer || !activeDrawBuffer->written_vertices) {
+        return;
+    }
+    recordedCommands++;
+    activeDrawBuffer->PostDraw();
+    activeDrawBuffer = nullptr;
+}
+
+void cEmptyRender::SetActiveDrawBuffer(DrawBuffer* db) {
+    if (activeDrawBuffer && activeDrawBuffer != db) {
+        if (activeDrawBuffer->IsLocked()) {
+            activeDrawBuffer->Unlock();
+        }
+        FinishActiveDrawBuffer();
+    }
+    cInterfaceRenderDevice::SetActiveDrawBuffer(db);
+}
+
+void cEmptyRender::SubmitDrawBuffer(DrawBuffer* db, DrawRange* range) {
+    if (activeDrawBuffer != db) {
+        FinishActiveDrawBuffer();
+    }
+    activeDrawBuffer = db;
+    FinishActiveDrawBuffer();
+}
+
+void cEmptyRender::EndDrawMesh() {
+    FinishActiveDrawBuffer();
+}
+
+void cEmptyRender::DrawNoMaterialMesh(cObjMesh* mesh, sDataRenderMaterial* data) {
+    if (BatchNoMaterialMesh(mesh, data)) {
+        return;
+    }
+    FinishActiveDrawBuffer();
+    cMeshTri* Tri = mesh->GetTri();
+    SubmitDrawBuffer(Tri->db, &Tri->dbr);
+}
+
+int cEmptyRender::Flush(bool wnd) {
+    FinishActiveDrawBuffer();
+    FrameStats = {};
+    FrameStats.commands = recordedCommands;
+    FrameStats.batched_meshes = batchedMeshes;
+    recordedCommands = 0;
+    batchedMeshes = 0;
+    return -1;
+}
+
 cInterfaceRenderDevice *gb_RenderDevice = nullptr;
 
 cInterfaceRenderDevice* CreateIRenderDevice(eRenderDeviceSelection selection) {
@@ -20,6 +20,17 @@ void cInterfaceRenderDevice::DrawSprite(int x1, int y1, int dx, int dy, float u1
     bool alpha = ColorMul.a < 255 || Texture->IsAlpha();
     if (mode <= ALPHA_TEST && alpha) mode = ALPHA_BLEND;
 
+    //Inside [0,1] the atlas copy looks the same, and consecutive sprites share one draw call
+    if (Texture->atlas &&
+        0 <= std::min(u1, u1 + du) && std::max(u1, u1 + du) <= 1 &&
+        0 <= std::min(v1, v1 + dv) && std::max(v1, v1 + dv) <= 1) {
+        u1 = Texture->atlas_u + u1 * Texture->atlas_du;
+        v1 = Texture->atlas_v + v1 * Texture->atlas_dv;
+        du *= Texture->atlas_du;
+        dv *= Texture->atlas_dv;
+        Texture = Texture->atlas;
+    }
+
     SetNoMaterial(mode,phase,Texture);
     UseOrthographicProjection();
 
@@ -137,6 +148,13 @@ void cInterfaceRenderDevice::DrawSprite2(int x1,int y1,int dx,int dy,
 
 // Text rendering functions 
 
+//Quads locked at once while writing text, capped by what the text DrawBuffer can hold
+static const size_t TEXT_LOCK_QUADS = 256;
+
+static size_t TextLockQuads(DrawBuffer* db) {
+    return std::min(TEXT_LOCK_QUADS, static_cast<size_t>(db->vb.NumberVertex / 4));
+}
+
 void cInterfaceRenderDevice::OutText(int x,int y,const char *string,const sColor4f& color,int align,eBlendMode blend_mode) {
     if (!CurrentFont) {
         VISASSERT(0 && "Font not set");
@@ -145,55 +163,65 @@ void cInterfaceRenderDevice::OutText(int x,int y,const char *string,const sColor
 
     sColor4c diffuse(color);
     cFontInternal* cf=CurrentFont->GetInternal();
+    const sFontLayout& layout = cf->GetLayout(string, CurrentFont->GetScale().x, diffuse);
 
-    float xOfs;
     float yOfs = static_cast<float>(y);
-    float xSize = CurrentFont->GetScale().x*static_cast<float>(cf->GetTexture()->GetWidth());
     float ySize = CurrentFont->GetScale().y*cf->FontHeight*static_cast<float>(cf->GetTexture()->GetHeight());
     float v_add = static_cast<float>(cf->FontHeight + 1.0 / static_cast<double>(cf->GetTexture()->GetHeight()));
 
     UseOrthographicProjection();
 
-    indices_t* i = nullptr;
+    //Whole string goes in as few locks as possible, color is converted only when it changes
     sVertexXYZDT1* v = nullptr;
+    size_t locked = 0;
+    size_t left = layout.glyphs.size();
+    uint32_t last_color = diffuse.v;
+    uint32_t converted = ConvertColor(diffuse);
     auto db = GetDrawBuffer(sVertexXYZDT1::fmt, PT_TRIANGLES, 10 * 4 * 10);
-    for (const char* str = string; 0 != *str; str++, yOfs += ySize) {
-        xOfs = static_cast<float>(x);
-        size_t chars;
-        float StringWidth = GetFontLength(str, &chars);
+    size_t lock_max = TextLockQuads(db);
+    for (const sFontLayoutLine& line : layout.lines) {
+        float xOfs = static_cast<float>(x);
         if (0 <= align) {
-            xOfs -= static_cast<float>(xm::round(StringWidth * (align == 0 ? 0.5f : 1)));
+            xOfs -= static_cast<float>(xm::round(line.width * (align == 0 ? 0.5f : 1)));
         }
-        for (; *str != 10; str++) {
-            ChangeTextColor(str, diffuse);
-            uint8_t c = *str;
-            if (!c || c == 10) break;
-            if (c < 32) continue;
-
-            db->AutoLockQuad<sVertexXYZDT1>(std::min(chars, static_cast<size_t>(10)), 1, v, i);
-
-            Vect3f& size = cf->Font[c];
+        for (int n = line.first; n < line.first + line.count; n++) {
+            if (!locked) {
+                db->AutoUnlock();
+                locked = std::min(left, lock_max);
+                v = db->LockQuad<sVertexXYZDT1>(locked);
+            }
+            const sFontLayoutGlyph& g = layout.glyphs[n];
+            const sFontGlyph& size = cf->Glyph[g.c];
+            sColor4c c = g.color;
+            c.a = diffuse.a;
+            if (c.v != last_color) {
+                last_color = c.v;
+                converted = ConvertColor(c);
+            }
 
             v[0].z = v[1].z = v[2].z = v[3].z = 0;
-            v[0].diffuse=v[1].diffuse=v[2].diffuse=v[3].diffuse=ConvertColor(diffuse);
-            v[0].x = v[1].x = static_cast<float>(xOfs);
-            v[0].y = v[2].y = static_cast<float>(yOfs);
-            xOfs += xSize * size.z - 1;
-            v[3].x = v[2].x = static_cast<float>(xOfs);
-            v[1].y = v[3].y = static_cast<float>(yOfs + ySize);
-
-            v[0].u1() = size.x;
-            v[0].v1() = size.y;
-            v[1].u1() = size.x;
-            v[1].v1() = size.y + v_add;
-            v[2].u1() = size.x + size.z;
-            v[2].v1() = size.y;
-            v[3].u1() = size.x + size.z;
-            v[3].v1() = size.y + v_add;
+            v[0].diffuse = v[1].diffuse = v[2].diffuse = v[3].diffuse = converted;
+            v[0].x = v[1].x = xOfs + g.x0;
+            v[0].y = v[2].y = yOfs;
+            v[3].x = v[2].x = xOfs + g.x1;
+            v[1].y = v[3].y = yOfs + ySize;
+
+            v[0].u1() = size.u;
+            v[0].v1() = size.v;
+            v[1].u1() = size.u;
+            v[1].v1() = size.v + v_add;
+            v[2].u1() = size.u + size.du;
+            v[2].v1() = size.v;
+            v[3].u1() = size.u + size.du;
+            v[3].v1() = size.v + v_add;
+
+            v += 4;
+            locked--;
+            left--;
         }
-        db->AutoUnlock();
-        if (*str == 0) break;
+        yOfs += ySize;
     }
+    db->AutoUnlock();
 }
 
 void cInterfaceRenderDevice::OutText(int x,int y,const char *string,const sColor4f& color,int align,eBlendMode blend_mode,
@@ -209,10 +237,9 @@ void cInterfaceRenderDevice::OutText(int x,int y,const char *string,const sColor
     duv.y *= 768.0f / static_cast<float>(GetSizeY());
     sColor4c diffuse(color);
     cFontInternal* cf=CurrentFont->GetInternal();
+    const sFontLayout& layout = cf->GetLayout(string, CurrentFont->GetScale().x, diffuse);
 
-    float xOfs;
     float yOfs = static_cast<float>(y);
-    float xSize = CurrentFont->GetScale().x*static_cast<float>(cf->GetTexture()->GetWidth());
     float ySize = CurrentFont->GetScale().y*cf->FontHeight*static_cast<float>(cf->GetTexture()->GetHeight());
     float v_add = static_cast<float>(cf->FontHeight + 1.0 / static_cast<double>(cf->GetTexture()->GetHeight()));
 
@@ -220,50 +247,48 @@ void cInterfaceRenderDevice::OutText(int x,int y,const char *string,const sColor
 
     indices_t* i = nullptr;
     sVertexXYZDT2* v = nullptr;
+    uint32_t last_color = diffuse.v;
+    uint32_t converted = ConvertColor(diffuse);
     auto db = GetDrawBuffer(sVertexXYZDT2::fmt, PT_TRIANGLES, 10 * 4 * 10);
-    for (const char* str=string; 0 != *str; str++) {
+    size_t lock_max = TextLockQuads(db);
+    for (const sFontLayoutLine& line : layout.lines) {
         if ((yOfs + ySize) < y_min) {
-            yOfs += ySize;
             //This line won't be visible, skip to next
-            for (; *str!=10; str++) {
-                ChangeTextColor(str, diffuse);
-                uint8_t c = *str;
-                if (!c || c == 10) break;
-                if (c < 32) continue;
-            }
+            yOfs += ySize;
             continue;
         }
         if (yOfs > y_max) {
             //Reached out of bounds, terminate
             break;
         }
-        xOfs = static_cast<float>(x);
-        size_t chars;
-        float StringWidth = GetFontLength(str, &chars);
+        float xOfs = static_cast<float>(x);
         if (0 <= align) {
-            xOfs -= static_cast<float>(xm::round(StringWidth * (align == 0 ? 0.5f : 1)));
+            xOfs -= static_cast<float>(xm::round(line.width * (align == 0 ? 0.5f : 1)));
         }
-        for (; *str!=10; str++) {
-            ChangeTextColor(str, diffuse);
-            uint8_t c = *str;
-            if (!c || c == 10) break;
-            if (c < 32) continue;
-
-            Vect3f& size = cf->Font[c];
+        size_t lock_quads = std::min(static_cast<size_t>(line.count), lock_max);
+        for (int n = line.first; n < line.first + line.count; n++) {
+            const sFontLayoutGlyph& g = layout.glyphs[n];
+            const sFontGlyph& size = cf->Glyph[g.c];
 
             float x0, x1, y0, y1;
-            x0 = xOfs;
-            x1 = xOfs + xSize * size.z - 1;
+            x0 = xOfs + g.x0;
+            x1 = xOfs + g.x1;
             y0 = yOfs;
             y1 = yOfs + ySize;
-            xOfs = x1;
 
             if (x1 < x_min || x0 > x_max) {
                 //Char is not visible as is before left edge or after right edge
                 continue;
             }
 
-            db->AutoLockQuad<sVertexXYZDT2>(std::min(chars, static_cast<size_t>(10)), 1, v, i);
+            sColor4c c = g.color;
+            c.a = diffuse.a;
+            if (c.v != last_color) {
+                last_color = c.v;
+                converted = ConvertColor(c);
+            }
+
+            db->AutoLockQuad<sVertexXYZDT2>(lock_quads, 1, v, i);
 
             v[1].x = v[3].x = x0;
             v[1].y = v[0].y = y0;
@@ -271,11 +296,11 @@ void cInterfaceRenderDevice::OutText(int x,int y,const char *string,const sColor
             v[2].y = v[3].y = y1;
 
             v[0].z=v[1].z=v[2].z=v[3].z=0;
-            v[0].diffuse=v[1].diffuse=v[2].diffuse=v[3].diffuse=gb_RenderDevice->ConvertColor(diffuse);
+            v[0].diffuse=v[1].diffuse=v[2].diffuse=v[3].diffuse=converted;
 
-            v[1].u2() = v[3].u2() = size.x;
-            v[1].v2() = v[0].v2() = size.y;
-            v[2].u2() = v[0].u2() = v[1].u2() + size.z;
+            v[1].u2() = v[3].u2() = size.u;
+            v[1].v2() = v[0].v2() = size.v;
+            v[2].u2() = v[0].u2() = v[1].u2() + size.du;
             v[2].v2() = v[3].v2() = v[1].v2() + v_add;
 
             v[1].u1() = v[3].u1() = (x0 - x) * duv.x + uv.x;
@@ -284,10 +309,8 @@ void cInterfaceRenderDevice::OutText(int x,int y,const char *string,const sColor
             v[2].v1() = v[3].v1() = (y1 - y) * duv.y + uv.y;
         }
         db->AutoUnlock();
-        if (*str == 0) break;
         yOfs += ySize;
     }
-    db->AutoUnlock();
 }
 
 // 2D primitives
@@ -0,0 +1,99 @@
+#include "StdAfxRD.h"
+#include <atomic>
+#include <SDL_thread.h>
+#include <SDL_cpuinfo.h>
+#include "RenderWorkers.h"
+
+static const int RENDER_WORKERS_MAX=7;
+
+struct sRenderWorkersState
+{
+	SDL_semaphore* start;
+	SDL_semaphore* done;
+	int number;//рабочих потоков, без графического
+
+	cRenderWorkers::range_proc proc;
+	void* param;
+	int count,chunk;
+	std::atomic<int> next;
+
+	void Process()
+	{
+		int begin;
+		while((begin=next.fetch_add(chunk))<count)
+			proc(param,begin,std::min(begin+chunk,count));
+	}
+};
+
+static sRenderWorkersState* render_workers=NULL;
+
+static int RenderWorkerThread(void* data)
+{
+	sRenderWorkersState* state=static_cast<sRenderWorkersState*>(data);
+	for(;;)
+	{
+		SDL_SemWait(state->start);
+		state->Process();
+		SDL_SemPost(state->done);
+	}
+	return 0;
+}
+
+//Потоки живут до конца процесса, как и поток логики
+static sRenderWorkersState* GetRenderWorkers()
+{
+	if(render_workers)
+		return render_workers;
+
+	render_workers=new sRenderWorkersState;
+	render_workers->start=SDL_CreateSemaphore(0);
+	render_workers->done=SDL_CreateSemaphore(0);
+	render_workers->number=0;
+	render_workers->count=0;
+	render_workers->next=0;
+
+	int number=std::min(SDL_GetCPUCount()-1,RENDER_WORKERS_MAX);
+	for(int i=0;i<number;i++)
+	{
+		SDL_Thread* thread=SDL_CreateThread(RenderWorkerThread,"perimeter_render_worker",render_workers);
+		if(!thread)
+			break;
+		SDL_DetachThread(thread);
+		render_workers->number++;
+	}
+	return render_workers;
+}
+
+int cRenderWorkers::GetNumber()
+{
+	return GetRenderWorkers()->number+1;
+}
+
+void cRenderWorkers::Run(int count,int chunk,range_proc proc,void* param)
+{
+	MTG();
+	if(count<=0)
+		return;
+	chunk=std::max(chunk,1);
+
+	sRenderWorkersState* state=GetRenderWorkers();
+	int number=std::min(state->number,(count-1)/chunk);
+	if(number<=0)
+	{
+		proc(param,0,count);
+		return;
+	}
+
+	state->proc=proc;
+	state->param=param;
+	state->count=count;
+	state->chunk=chunk;
+	state->next=0;
+	for(int i=0;i<number;i++)
+		SDL_SemPost(state->start);
+
+	state->Process();
+
+	for(int i=0;i<number;i++)
+		SDL_SemWait(state->done);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+//Потоки для независимой работы внутри кадра: пересчёт боксов отсечения,
+//сортировка прозрачных объектов. PreDraw объектов сюда не выносится,
+//он создаёт эффекты и пишет в общие списки камеры.
+//Run вызывается только из графического потока и возвращается,
+//когда все куски [begin,end) обработаны.
+class cRenderWorkers
+{
+public:
+	typedef void (*range_proc)(void* param,int begin,int end);
+
+	static void Run(int count,int chunk,range_proc proc,void* param);
+	//Число потоков, включая вызывающий
+	static int GetNumber();
+};
+
+template<class Func>
+void RenderParallelFor(int count,int chunk,Func& func)
+{
+	cRenderWorkers::Run(count,chunk,[](void* param,int begin,int end){
+		(*static_cast<Func*>(param))(begin,end);
+	},&func);
+}
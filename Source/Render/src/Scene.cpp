@@ -1,5 +1,6 @@
 #include "StdAfxRD.h"
 
+#include <atomic>
 #include <climits>
 #include <typeinfo>
 
@@ -13,6 +14,7 @@
 #include "cPlane.h"
 #include "CChaos.h"
 #include "../client/Silicon.h"
+#include "RenderWorkers.h"
 
 FILE *gb_fSceneLog=NULL;
 
@@ -190,6 +192,206 @@ void cScene::PreDraw(cCamera *DrawNode)
 {
 }
 
+static const int CULL_TREE_LEAF_SIZE=8;
+static const int CULL_TREE_UPDATE_CHUNK=256;
+
+void cSceneCullTree::Update(MTGVector& grid)
+{
+	bool changed=slots.size()!=grid.size() || !std::equal(grid.begin(),grid.end(),slots.begin());
+	if(changed)
+	{
+		slots.assign(grid.begin(),grid.end());
+		sLeaf empty;
+		empty.obj=NULL;
+		empty.visible=VISIBLE_INTERSECT;
+		leaves.assign(slots.size(),empty);
+	}
+
+	//Листья независимы, считаются по кускам в потоках cRenderWorkers
+	std::atomic<int> moved_now(0),added(0);
+	auto update_leaves=[this,&moved_now,&added](int begin,int end)
+	{
+		int moved_range=0,added_range=0;
+		for(int i=begin;i<end;i++)
+		{
+#ifdef MTGVECTOR_USE_HANDLES
+			cIUnkClass* p=safe_cast<cIUnkClass*>(slots[i]->Get());
+#else
+			cIUnkClass* p=slots[i];
+#endif
+			cObjectNodeRoot* root=(p && p->GetKind()==KIND_OBJ_NODE_ROOT)?safe_cast<cObjectNodeRoot*>(p):NULL;
+			sLeaf& l=leaves[i];
+			if(!root)
+			{
+				l.obj=NULL;
+				continue;
+			}
+
+			const MatXf& m=root->GetGlobalMatrix();
+			const sBox6f& b=root->GetLocalBound();
+			if(l.obj==root && memcmp(&l.matrix,&m,sizeof(m))==0 && memcmp(&l.bound,&b,sizeof(b))==0)
+				continue;
+
+			if(l.obj!=root)
+				added_range++;
+			l.obj=root;
+			l.matrix=m;
+			l.bound=b;
+			//Те же углы, что проверяет cCamera::TestVisible
+			l.world.SetInvalidBox();
+			for(int k=0;k<8;k++)
+			{
+				Vect3f p;
+				m.xformPoint(Vect3f((k&1)?b.max.x:b.min.x,(k&2)?b.max.y:b.min.y,(k&4)?b.max.z:b.min.z),p);
+				l.world.AddBound(p);
+			}
+			moved_range++;
+		}
+		moved_now+=moved_range;
+		added+=added_range;
+	};
+	RenderParallelFor(slots.size(),CULL_TREE_UPDATE_CHUNK,update_leaves);
+
+	if(added)
+		changed=true;
+	moved+=moved_now;
+	if(changed || moved>order.size()/2)
+		Build();
+	else if(moved_now>0)
+		Refit();
+}
+
+void cSceneCullTree::Build()
+{
+	order.clear();
+	nodes.clear();
+	moved=0;
+	for(int i=0;i<leaves.size();i++)
+		if(leaves[i].obj)
+			order.push_back(i);
+	if(order.empty())
+		return;
+
+	BuildNode(0,order.size());
+	Refit();
+}
+
+int cSceneCullTree::BuildNode(int first,int count)
+{
+	int index=nodes.size();
+	nodes.push_back(sNode());
+	nodes[index].first=first;
+	nodes[index].count=count;
+	nodes[index].right=-1;
+	if(count<=CULL_TREE_LEAF_SIZE)
+		return index;
+
+	//Делим пополам по самой длинной оси центров
+	sBox6f centers;
+	centers.SetInvalidBox();
+	for(int i=first;i<first+count;i++)
+	{
+		const sBox6f& w=leaves[order[i]].world;
+		centers.AddBound((w.min+w.max)*0.5f);
+	}
+	Vect3f size=centers.max-centers.min;
+	int axis=size.x>=size.y?(size.x>=size.z?0:2):(size.y>=size.z?1:2);
+
+	int half=count/2;
+	std::nth_element(order.begin()+first,order.begin()+first+half,order.begin()+first+count,
+		[this,axis](int a,int b){
+			const sBox6f& wa=leaves[a].world;
+			const sBox6f& wb=leaves[b].world;
+			return wa.min[axis]+wa.max[axis]<wb.min[axis]+wb.max[axis];
+		});
+
+	BuildNode(first,half);
+	int right=BuildNode(first+half,count-half);
+	nodes[index].right=right;
+	return index;
+}
+
+void cSceneCullTree::Refit()
+{
+	//Потомки всегда после родителя
+	for(int i=nodes.size()-1;i>=0;i--)
+	{
+		sNode& node=nodes[i];
+		if(node.right<0)
+		{
+			node.box.SetInvalidBox();
+			for(int j=node.first;j<node.first+node.count;j++)
+			{
+				const sBox6f& w=leaves[order[j]].world;
+				node.box.AddBound(w.min);
+				node.box.AddBound(w.max);
+			}
+		}else
+		{
+			node.box=nodes[i+1].box;
+			node.box.AddBound(nodes[node.right].box.min);
+			node.box.AddBound(nodes[node.right].box.max);
+		}
+	}
+}
+
+void cSceneCullTree::Test(cCamera* camera)
+{
+	if(nodes.empty())
+		return;
+
+	int stack[64];
+	int stack_size=0;
+	stack[stack_size++]=0;
+	while(stack_size>0)
+	{
+		const sNode& node=nodes[stack[--stack_size]];
+		int visible=camera->TestVisibleBound(node.box.min,node.box.max);
+		if(visible!=VISIBLE_INTERSECT)
+		{
+			SetVisible(node,visible);
+			continue;
+		}
+
+		if(node.right>=0)
+		{
+			VISASSERT(stack_size+2<=64);
+			stack[stack_size++]=node.right;
+			stack[stack_size++]=&node-&nodes[0]+1;
+			continue;
+		}
+
+		for(int j=node.first;j<node.first+node.count;j++)
+		{
+			sLeaf& l=leaves[order[j]];
+			l.visible=camera->TestVisibleBound(l.world.min,l.world.max);
+		}
+	}
+}
+
+void cSceneCullTree::SetVisible(const sNode& node,int visible)
+{
+	for(int j=node.first;j<node.first+node.count;j++)
+		leaves[order[j]].visible=visible;
+}
+
+int cSceneCullTree::GetVisible(int slot,cIUnkClass* obj)
+{
+	if(slot>=leaves.size())
+		return VISIBLE_INTERSECT;
+	sLeaf& l=leaves[slot];
+	if(!l.obj || l.obj!=obj)
+		return VISIBLE_INTERSECT;
+	//Объекты с привязками обновляют их до теста видимости
+	if(l.obj->HasObservers())
+		return VISIBLE_INTERSECT;
+	//Мог сдвинуться в PreDraw другого объекта
+	if(memcmp(&l.matrix,&l.obj->GetGlobalMatrix(),sizeof(MatXf))!=0 ||
+		memcmp(&l.bound,&l.obj->GetLocalBound(),sizeof(sBox6f))!=0)
+		return VISIBLE_INTERSECT;
+	return l.visible;
+}
+
 void cScene::Draw(cCamera *DrawNode)
 {
 	MTEnter enter(lock_draw);
@@ -215,15 +417,24 @@ void cScene::Draw(cCamera *DrawNode)
 			DrawNode->EnableGridTest(TileNumber.x,TileNumber.y,tile_size);
 	}
 
+    //Модели отсекаются группами по иерархии боксов, порядок PreDraw прежний
+    cull_tree.Update(grid);
+    cull_tree.Test(DrawNode);
+
     grid.DisableChanges(true);
-    for (auto el : grid) {
+    for (i=0;i<grid.size();i++) {
 #ifdef MTGVECTOR_USE_HANDLES
-        cIUnkClass* obj = safe_cast<cIUnkClass*>(el->Get());
+        cIUnkClass* obj = safe_cast<cIUnkClass*>(grid.get(i)->Get());
 #else
-        cIUnkClass* obj = el;
+        cIUnkClass* obj = grid.get(i);
 #endif
         if (obj&&obj->GetAttr(ATTRUNKOBJ_IGNORE)==0) {
-            obj->PreDraw(DrawNode);
+            int visible = cull_tree.GetVisible(i, obj);
+            if (visible == VISIBLE_INSIDE) {
+                safe_cast<cObjectNodeRoot*>(obj)->PreDrawVisible(DrawNode);
+            } else if (visible == VISIBLE_INTERSECT) {
+                obj->PreDraw(DrawNode);
+            }
         }
     }
     grid.DisableChanges(false);
@@ -317,6 +528,22 @@ bool cScene::GetLighting(sColor4f &Ambient,sColor4f &Diffuse,sColor4f &Specular,
 #define TRACE_DEBUG 0
 #define PREC_TRACE							10
 #define PREC_TRACE_RAY						18
+
+//Сколько шагов луча подряд (начиная с первого) координата остаётся в блоке пирамиды уровня level
+static int64_t TraceStepsInBlock(int64_t p, int d, int level)
+{
+	if (d == 0) {
+		return INT32_MAX;
+	}
+	int64_t block = ((p + d) >> PREC_TRACE_RAY) >> level;
+	if (d > 0) {
+		int64_t bound = (block + 1) << (level + PREC_TRACE_RAY);
+		return (bound - 1 - p) / d;
+	} else {
+		int64_t bound = block << (level + PREC_TRACE_RAY);
+		return (p - bound) / -d;
+	}
+}
 bool cScene::Trace(const Vect3f& pStart,const Vect3f& pFinish,Vect3f *pTrace, bool ignore_height, bool ignore_bounds)
 { // тест на пересечение луча с объектами сцены, в том числе и с ландшафтом
 
@@ -392,7 +619,40 @@ bool cScene::Trace(const Vect3f& pStart,const Vect3f& pFinish,Vect3f *pTrace, bo
 	int xb_= xm::round(xb * (1 << PREC_TRACE_RAY));
     int yb_= xm::round(yb * (1 << PREC_TRACE_RAY));
     int zb_= xm::round(zb * (1 << PREC_TRACE_RAY));
+
+    //Блоки пирамиды максимумов, целиком лежащие ниже луча, проходим за один раз,
+    //результат тот же, что и при проверке каждой клетки
+    const cTileMapMaxMip* mip = ignore_height ? nullptr : &TileMap->GetMaxMip();
+    int mip_level = 1;
 	while (true) {
+        if (mip && mip_level <= mip->GetLevels()) {
+            int xbn = (xb_ + dx_) >> PREC_TRACE_RAY;
+            int ybn = (yb_ + dy_) >> PREC_TRACE_RAY;
+            if (xbn>=0 && xbn<x_size && ybn>=0 && ybn<y_size) {
+                int bx = xbn >> mip_level;
+                int by = ybn >> mip_level;
+                if (((bx + 1) << mip_level) <= x_size && ((by + 1) << mip_level) <= y_size) {
+                    int64_t steps = std::min(TraceStepsInBlock(xb_, dx_, mip_level), TraceStepsInBlock(yb_, dy_, mip_level));
+                    int64_t zb_last = zb_ + steps * dz_;
+                    int z_first = (zb_ + dz_) >> PREC_TRACE_RAY;
+                    int z_last = static_cast<int>(zb_last >> PREC_TRACE_RAY);
+                    //Переполнение zb_ обрабатываем по шагам, как и раньше
+                    if (INT32_MIN <= zb_last && zb_last <= INT32_MAX &&
+                        mip->GetMax(mip_level, bx, by) < std::min(z_first, z_last)) {
+                        xb_ += static_cast<int>(steps * dx_);
+                        yb_ += static_cast<int>(steps * dy_);
+                        zb_ = static_cast<int>(zb_last);
+                        mip_level = std::min(mip_level + 1, mip->GetLevels());
+                        continue;
+                    }
+                }
+                if (1 < mip_level) {
+                    mip_level--;
+                    continue;
+                }
+            }
+        }
+
         xb_+=dx_;
         yb_+=dy_;
         zb_+=dz_;
@@ -9,6 +9,45 @@ class terUnitBase;
 class cEffect;
 #include "VisGrid2d.h"
 
+//Иерархия боксов моделей сцены для отсечения в cScene::Draw.
+//Листья соответствуют слотам grid, бокс листа пересчитывается только когда
+//объект сдвинулся, дерево перестраивается при смене набора объектов
+//или когда с последней перестройки сдвинулась половина листьев.
+class cSceneCullTree
+{
+public:
+	cSceneCullTree():moved(0){}
+	void Update(MTGVector& grid);
+	void Test(cCamera* camera);
+	//eTestVisible для объекта в слоте, VISIBLE_INTERSECT - неизвестно, проверять самому объекту
+	int GetVisible(int slot,cIUnkClass* obj);
+protected:
+	struct sLeaf
+	{
+		cObjectNodeRoot* obj;
+		MatXf matrix;//GetGlobalMatrix() и GetLocalBound() на момент расчёта world
+		sBox6f bound;
+		sBox6f world;
+		int visible;
+	};
+	struct sNode
+	{
+		sBox6f box;
+		int first,count;//листья order[first..first+count)
+		int right;//левый потомок следующий в nodes, right<0 - концевой узел
+	};
+	std::vector<MTGVector::ptr_t> slots;
+	std::vector<sLeaf> leaves;
+	std::vector<int> order;
+	std::vector<sNode> nodes;
+	int moved;
+
+	void Build();
+	int BuildNode(int first,int count);
+	void Refit();
+	void SetVisible(const sNode& node,int visible);
+};
+
 class cScene : public cUnknownClass
 {
 public:
@@ -117,6 +156,7 @@ private:
 	MTGVector			UnkLightArray;				// массив источников света сцены
     MTGVector			grid;
 	QuatTree			tree;
+	cSceneCullTree		cull_tree;
 
 	class cTileMap *TileMap;
 
@@ -50,10 +50,16 @@ bool ShadowVolume::Add(MatXf& mat,cMeshTri* pTri)
 
 void ShadowVolume::EndAdd()
 {
+	normal_x.resize(triangle.size());
+	normal_y.resize(triangle.size());
+	normal_z.resize(triangle.size());
 	for(int i=0;i<triangle.size();i++)
 	{
 		sv_triangle& t=triangle[i];
 		t.n.Set(vertex[t.v[0]],vertex[t.v[1]],vertex[t.v[2]]);
+		normal_x[i]=t.n.A;
+		normal_y[i]=t.n.B;
+		normal_z[i]=t.n.C;
 	}
 
 	ComputeWingedEdges();
@@ -214,113 +220,90 @@ void ShadowVolume::DrawEdge(cCamera *camera,const MatXf& mat,Vect3f light)
 	}
 }
 
-// This routine draws the extruded "possible silhouette" edge.  The
-// edge is extruded to infinity.
+// Silhouette edge is an edge between lit and unlit triangle, open edges
+// are always silhouette. Facing of all triangles is computed first in a
+// plain loop over separate normal arrays, which compiler vectorizes, then
+// edges only compare two precomputed values.
 
-// The paper describes identifying silhouette edge loops.  The approach
-// in this demo is to visit each edge, determine if it's a "possible silhouette"
-// or not, and if it is, draw the extruded edge.   This approach is not
-// as efficient, but it has the benefit of being extremely simple.
+int ShadowVolume::ExtractSilhouette(const Vect3f& olight)
+{
+	VISASSERT(normal_x.size()==triangle.size());
+	int tsize=triangle.size();
+	facing.resize(tsize);
+
+	const float* nx=normal_x.data();
+	const float* ny=normal_y.data();
+	const float* nz=normal_z.data();
+	float* f=facing.data();
+	const float lx=olight.x,ly=olight.y,lz=olight.z;
+	for(int i=0;i<tsize;i++)
+		f[i]=nx[i]*lx+ny[i]*ly+nz[i]*lz;
+
+	silhouette.clear();
+	for(const sv_edge& we : edge)
+	{
+		float f0=f[we.w[0]];
+		float f1=we.w[1]!=-1?f[we.w[1]]:-f0;
+		if(f0>=0 && f1<0)
+		{
+			silhouette.push_back(we.e[1]);
+			silhouette.push_back(we.e[0]);
+		}else if(f1>=0 && f0<0)
+		{
+			silhouette.push_back(we.e[0]);
+			silhouette.push_back(we.e[1]);
+		}
+	}
+	return silhouette.size()/2;
+}
 
-// This routine also doubles as the routine for drawing the local and ininite
-// silhouette edges (when prim == GL_LINES).
+// Extruded quads are written in world space, so volumes of all objects
+// go to one shared DrawBuffer and are drawn by FlushVolumes.
+// mat*(p+olight*k) == mat*p+light_dir*k, because olight=mat.rot()^-1*light_dir.
 
 void ShadowVolume::DrawVolume(cCamera *camera,const MatXf& mat,Vect3f light_dir,bool line)
 {
+	if(line)
+	{
+		for(const sv_edge& we : edge)
+		{
+			sColor4c c=we.w[1]==-1?sColor4c(255,0,0,255):sColor4c(255,255,255,255);
+			gb_RenderDevice->DrawLine(mat*vertex[we.e[0]],mat*vertex[we.e[1]],c);
+		}
+		return;
+	}
+
 	Mat3f mat_inv;
 	mat_inv.invert(mat.rot());
 	Vect3f olight=mat_inv*light_dir;
-    
-    DrawBuffer* db = nullptr;
-    uint32_t color = gb_RenderDevice->ConvertColor(sColor4c(0,0,0,128));
-
-    if (!line) {
-        db = camera->GetRenderDevice()->GetDrawBuffer(sVertexXYZDT1::fmt, PT_TRIANGLES);
-    }
 
-    for (auto & we : edge) {
-//		if(we.w[0] == -1 || we.w[1] == -1)
-//		   continue;
+	int count=ExtractSilhouette(olight);
+	if(!count)
+		return;
 
-        sv_triangle& p0 = triangle[we.w[0]];
-        float f0 = //p0.n.GetDistance(olight);
-                    p0.n.A*olight.x+p0.n.B*olight.y+p0.n.C*olight.z;
-            
-        float f1 = -f0;
-        if(we.w[1] != -1)
-        {
-            sv_triangle& p1 = triangle[we.w[1]];
-            f1 = p1.n.A*olight.x+p1.n.B*olight.y+p1.n.C*olight.z;
-                //p1.n.GetDistance(olight);
-        }
+	DrawBuffer* db=camera->GetRenderDevice()->GetDrawBuffer(sVertexXYZDT1::fmt, PT_TRIANGLES);
+	uint32_t color=gb_RenderDevice->ConvertColor(sColor4c(0,0,0,128));
+	Vect3f extrude=light_dir*1000;
 
-
-        int edge[2];
-
-        if(f0 >= 0 && f1 < 0) {
-            edge[0] = we.e[1];
-            edge[1] = we.e[0];
-        } else if(f1 >= 0 && f0 < 0) {
-            edge[0] = we.e[0];
-            edge[1] = we.e[1];
-        } else {
-            if(line) {
-                edge[0] = we.e[0];
-                edge[1] = we.e[1];
-            } else {
-                continue;
-            }
-        }
-        
-        Vect3f& pn0 = vertex[edge[0]];
-        Vect3f& pn1 = vertex[edge[1]];
-
-        if(line) {
-            if(we.w[1] == -1) {
-                gb_RenderDevice->DrawLine(mat * pn0, mat * pn1, sColor4c(255, 0, 0, 255));
-            } else {
-                gb_RenderDevice->DrawLine(mat * pn0, mat * pn1, sColor4c(255, 255, 255, 255));
-            }
-        } else {
-            sVertexXYZDT1 *v = nullptr;
-            indices_t* ib = nullptr;
-            db->Lock(6, 6, v, ib, true);
-            Vect3f v2=pn0+olight*1000;
-            Vect3f v3=pn1+olight*1000;
-            v[0].setPos(pn0); v[0].diffuse=color;
-            v[1].setPos(pn1); v[1].diffuse=color;
-            v[2].setPos(v2); v[2].diffuse=color;
-
-            v[3].setPos(pn1); v[3].diffuse=color;
-            v[4].setPos(v3); v[4].diffuse=color;
-            v[5].setPos(v2); v[5].diffuse=color;
-
-            for (int i = 0; i < 6; ++i) {
-                ib[i] = i;
-            }
-            db->Unlock();
-        }
-/*
-        // local segment
-        glVertex4f(pn0.x, pn0.y, pn0.z, 1);
-        glVertex4f(pn1.x, pn1.y, pn1.z, 1);
-
-        // segment projected to infinity
-        glVertex4f(pn1.x*olight[3] - olight[0],
-            pn1.y*olight[3] - olight[1],
-            pn1.z*olight[3] - olight[2],
-            0);
-        glVertex4f(pn0.x*olight[3] - olight[0],
-            pn0.y*olight[3] - olight[1],
-            pn0.z*olight[3] - olight[2],
-            0);
-*/
-    }
-
-    if(!line)
-    {
-        db->Unlock();
-        db->Draw();
-    }
+	sVertexXYZDT1* v=nullptr;
+	indices_t* ib=nullptr;
+	for(int i=0;i<count;i++)
+	{
+		Vect3f pn0=mat*vertex[silhouette[2*i]];
+		Vect3f pn1=mat*vertex[silhouette[2*i+1]];
+
+		db->AutoLockQuad(count+1, 1, v, ib);
+		v[0].setPos(pn0); v[0].diffuse=color;
+		v[1].setPos(pn1); v[1].diffuse=color;
+		v[2].setPos(pn0+extrude); v[2].diffuse=color;
+		v[3].setPos(pn1+extrude); v[3].diffuse=color;
+	}
+	db->AutoUnlock();
 }
 
+void ShadowVolume::FlushVolumes(cCamera *camera)
+{
+	DrawBuffer* db=camera->GetRenderDevice()->GetDrawBuffer(sVertexXYZDT1::fmt, PT_TRIANGLES);
+	db->AutoUnlock();
+	db->Draw();
+}
@@ -17,6 +17,12 @@ class ShadowVolume:public cUnknownClass
 	std::vector<Vect3f> vertex;
 	std::vector<sv_triangle> triangle;
 	std::vector<sv_edge> edge;
+
+	//Нормали треугольников отдельными массивами, освещенность всех граней считается одним проходом
+	std::vector<float> normal_x,normal_y,normal_z;
+	std::vector<float> facing;
+	//Пары вершин рёбер силуэта в порядке обхода для экструзии
+	std::vector<int> silhouette;
 public:
 	ShadowVolume();
 	~ShadowVolume();
@@ -25,10 +31,13 @@ public:
 	void EndAdd();
 
 	void Draw(cCamera *camera,const MatXf& m,Vect3f light_dir,bool line);
+	//Объемы всех объектов пишутся в общий DrawBuffer в мировых координатах, вызывать после Draw всех объектов
+	static void FlushVolumes(cCamera *camera);
 protected:
 	void DeleteRepeatedVertex(int offset_vertex,int size_vertex,int offset_poly,int size_poly);
 	int ComputeWingedEdges();
 	void AddEdge(sv_edge& we);
+	int ExtractSilhouette(const Vect3f& olight);
 
 	void DrawEdge(cCamera *camera,const MatXf& m,Vect3f light_dir);
 	void DrawVolume(cCamera *camera,const MatXf& m,Vect3f light_dir,bool line);
@@ -71,6 +71,8 @@ void cTexLibrary::FreeOne(FILE* f)
 		cTexture*& p=*it;
 		if(p && p->GetRef()==1)
 		{
+			if(p->atlas)
+				RemoveFromAtlas(p);
 			p->Release();
 			p=NULL;
 			compacted++;
@@ -99,7 +101,17 @@ void cTexLibrary::Compact(FILE* f)
 void cTexLibrary::Free(FILE* f)
 {
 	FreeOne(f);
+	//Оставшиеся текстуры живут дальше без атласа
+	std::vector<cTexture*>::iterator it;
+	FOR_EACH(textures,it)
+		if(*it)
+			(*it)->atlas=nullptr;
 	textures.clear();
+
+	std::vector<sAtlasPage>::iterator it_page;
+	FOR_EACH(atlas_pages,it_page)
+		RELEASE(it_page->texture);
+	atlas_pages.clear();
 }
 
 cTexture* cTexLibrary::CreateRenderTexture(int width, int height, uint32_t attr, bool enable_assert)
@@ -364,6 +376,9 @@ bool cTexLibrary::ReLoadTexture(cTexture* Texture)
 
 	int err=gb_RenderDevice->CreateTexture(Texture,FileImage);
 
+	if(!err)
+		AddToAtlas(Texture,FileImage);
+
 	delete FileImage;
 	if(err)
 	{
@@ -375,6 +390,133 @@ bool cTexLibrary::ReLoadTexture(cTexture* Texture)
 	return true;
 }
 
+static const int ATLAS_PAGE_SIZE=1024;
+static const int ATLAS_PAGES_MAX=8;
+static const int ATLAS_TEXTURE_MAX=128;
+
+bool cTexLibrary::sAtlasPage::Place(int dx,int dy,Vect2i& pos)
+{
+	if(shelf_x+dx>ATLAS_PAGE_SIZE)
+	{
+		shelf_y+=shelf_height;
+		shelf_x=0;
+		shelf_height=0;
+	}
+	if(shelf_y+dy>ATLAS_PAGE_SIZE || dx>ATLAS_PAGE_SIZE)
+		return false;
+
+	pos.set(shelf_x,shelf_y);
+	shelf_x+=dx;
+	shelf_height=std::max(shelf_height,dy);
+	return true;
+}
+
+void cTexLibrary::AddToAtlas(cTexture* Texture,cFileImage* FileImage)
+{
+	if(Texture->atlas)
+		RemoveFromAtlas(Texture);
+
+	int dx=Texture->GetWidth(),dy=Texture->GetHeight();
+	if(Texture->GetNumberFrame()!=1 || Texture->GetNumberMipMap()!=1)
+		return;
+	if(dx<=0 || dy<=0 || dx>ATLAS_TEXTURE_MAX || dy>ATLAS_TEXTURE_MAX)
+		return;
+	if(Texture->GetAttribute(TEXTURE_BUMP|TEXTURE_NORMAL|TEXTURE_UVBUMP))
+		return;
+
+	//Вокруг текстуры рамка из её же краёв, чтобы фильтрация не брала соседей
+	uint32_t attribute=Texture->GetAttribute(TEXTURE_ALPHA_BLEND|TEXTURE_ALPHA_TEST);
+	sAtlasPage* page=NULL;
+	sAtlasPage saved;
+	Vect2i pos;
+	std::vector<sAtlasPage>::iterator it;
+	FOR_EACH(atlas_pages,it)
+	{
+		if(it->attribute!=attribute)
+			continue;
+		saved=*it;
+		if(it->Place(dx+2,dy+2,pos))
+		{
+			page=&*it;
+			break;
+		}
+		*it=saved;
+	}
+
+	if(!page)
+	{
+		if(atlas_pages.size()>=ATLAS_PAGES_MAX)
+			return;
+		cTexture* texture=CreateTexture(ATLAS_PAGE_SIZE,ATLAS_PAGE_SIZE,attribute!=0);
+		if(!texture)
+			return;
+		if(attribute==TEXTURE_ALPHA_TEST)
+		{
+			texture->ClearAttribute(TEXTURE_ALPHA_BLEND);
+			texture->SetAttribute(TEXTURE_ALPHA_TEST);
+		}
+		texture->label="atlas";
+
+		sAtlasPage new_page;
+		new_page.texture=texture;
+		new_page.attribute=attribute;
+		new_page.users=0;
+		new_page.shelf_x=new_page.shelf_y=new_page.shelf_height=0;
+		atlas_pages.push_back(new_page);
+		page=&atlas_pages.back();
+		saved=*page;
+		page->Place(dx+2,dy+2,pos);
+	}
+
+	int pitch=0;
+	uint8_t* data=page->texture->LockTexture(pitch);
+	if(!data)
+	{
+		//Текстура остаётся сама по себе, место на странице возвращаем
+		*page=saved;
+		return;
+	}
+
+	//Читаем как при загрузке в CreateTexture, пишем в формате устройства
+	std::vector<uint8_t> buf(dx*dy*4,0xFF);
+	FileImage->GetTextureRGB(&buf[0],0,4,4*dx,8,8,8,0,8,16,dx,dy);
+	if(attribute)
+		FileImage->GetTextureAlpha(&buf[0],0,4,4*dx,8,24,dx,dy);
+
+	for(int y=-1;y<=dy;y++)
+	{
+		uint32_t* out=reinterpret_cast<uint32_t*>(data+(pos.y+1+y)*pitch)+pos.x+1;
+		const uint8_t* in=&buf[clamp(y,0,dy-1)*dx*4];
+		for(int x=-1;x<=dx;x++)
+		{
+			const uint8_t* c=in+clamp(x,0,dx-1)*4;
+			out[x]=gb_RenderDevice->ConvertColor(sColor4c(c[0],c[1],c[2],c[3]));
+		}
+	}
+	page->texture->UnlockTexture();
+
+	page->users++;
+	Texture->atlas=page->texture;
+	Texture->atlas_u=(pos.x+1)/float(ATLAS_PAGE_SIZE);
+	Texture->atlas_v=(pos.y+1)/float(ATLAS_PAGE_SIZE);
+	Texture->atlas_du=dx/float(ATLAS_PAGE_SIZE);
+	Texture->atlas_dv=dy/float(ATLAS_PAGE_SIZE);
+}
+
+void cTexLibrary::RemoveFromAtlas(cTexture* Texture)
+{
+	std::vector<sAtlasPage>::iterator it;
+	FOR_EACH(atlas_pages,it)
+	if(it->texture==Texture->atlas)
+	{
+		//Место не освобождается по одной текстуре, страница очищается целиком
+		if(--it->users==0)
+			it->shelf_x=it->shelf_y=it->shelf_height=0;
+		break;
+	}
+	Texture->atlas=nullptr;
+}
+
 void cTexLibrary::Error(cTexture* Texture) {
 	if(enable_error) {
         VisError << "Error: cTexLibrary::GetElement()\r\nTexture is bad: " << Texture->GetName().c_str() << "."
@@ -386,7 +528,19 @@ void cTexLibrary::ReloadAllTexture()
 {
 	MTAuto mtenter(&lock);
 
+	//Место на страницах освобождается только целиком, поэтому атлас
+	//собирается заново из перезагружаемых текстур
 	std::vector<cTexture*>::iterator it;
+	FOR_EACH(textures,it)
+		if(*it)
+			(*it)->atlas=nullptr;
+	std::vector<sAtlasPage>::iterator it_page;
+	FOR_EACH(atlas_pages,it_page)
+	{
+		it_page->users=0;
+		it_page->shelf_x=it_page->shelf_y=it_page->shelf_height=0;
+	}
+
 	FOR_EACH(textures,it)
 	{
 		cTexture* p=*it;
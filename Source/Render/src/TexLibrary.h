@@ -1,6 +1,7 @@
 #pragma once
 
 class cTexture;
+class cFileImage;
 
 class cTexLibrary
 {
@@ -39,6 +40,20 @@ private:
 
 	void Error(cTexture* Texture);
 
+	//Мелкие текстуры без мипмапов (интерфейс) копируются в общие страницы,
+	//чтобы спрайты из разных текстур рисовались одним вызовом
+	struct sAtlasPage
+	{
+		cTexture* texture;
+		uint32_t attribute;//TEXTURE_ALPHA_BLEND|TEXTURE_ALPHA_TEST у всех текстур страницы
+		int users;
+		int shelf_x,shelf_y,shelf_height;
+		bool Place(int dx,int dy,Vect2i& pos);
+	};
+	std::vector<sAtlasPage> atlas_pages;
+	void AddToAtlas(cTexture* Texture,cFileImage* FileImage);
+	void RemoveFromAtlas(cTexture* Texture);
+
 #ifdef PERIMETER_D3D9
 	bool ReLoadDDS(cTexture* Texture);
 #endif
@@ -44,6 +44,9 @@ public:
     float       bump_scale = 1;
 	std::vector<TextureImage> frames;
     std::string		label = {};
+	//Копия в общем атласе cTexLibrary для 2D спрайтов с uv внутри [0,1]
+	cTexture*	atlas = nullptr;
+	float		atlas_u = 0, atlas_v = 0, atlas_du = 1, atlas_dv = 1;
 
 	cTexture(const char *TexName=0);
 	~cTexture();
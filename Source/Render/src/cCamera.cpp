@@ -10,6 +10,7 @@
 #include <algorithm>
 #include "tilemap/TileMap.h"
 #include "Font.h"
+#include "RenderWorkers.h"
 #include "VertexFormat.h"
 #include "SafeCast.h"
 
@@ -250,9 +251,11 @@ void cCamera::DrawScene()
 	{
 		RenderDevice->SetRenderState(RS_CULLMODE, CULL_NONE);
 		RenderDevice->SetNoMaterial(ALPHA_BLEND);
+		RenderDevice->SetWorldMatXf(MatXf::ID);
 		
 		for(int i=0;i<ShadowTestArray.size();i++)
 			ShadowTestArray[i]->DrawShadow(this);
+		ShadowVolume::FlushVolumes(this);
 		RenderDevice->SetRenderState( RS_CULLMODE, CULL_CAMERA);
 	}
 
@@ -679,6 +682,39 @@ void cCamera::SetCopy(cCamera* DrawNode)
 	
 }
 
+static const int SORT_PARALLEL_MIN=1024;
+
+//Куски сортируются в потоках cRenderWorkers и сливаются попарно,
+//результат тот же, что у stable_sort по всему массиву
+void cCamera::SortObjects()
+{
+	int size=SortArray.size();
+	int number=cRenderWorkers::GetNumber();
+	if(size<SORT_PARALLEL_MIN || number<2)
+	{
+		stable_sort(SortArray.begin(),SortArray.end(),ObjectSortByRadius());
+		return;
+	}
+
+	int chunk=(size+number-1)/number;
+	auto sort_chunks=[this,chunk,size](int begin,int end)
+	{
+		for(int i=begin;i<end && i*chunk<size;i++)
+		{
+			std::vector<ObjectSort>::iterator first=SortArray.begin()+i*chunk;
+			stable_sort(first,first+std::min(chunk,size-i*chunk),ObjectSortByRadius());
+		}
+	};
+	RenderParallelFor(number,1,sort_chunks);
+
+	for(int width=chunk;width<size;width*=2)
+	for(int first=0;first+width<size;first+=2*width)
+	{
+		std::vector<ObjectSort>::iterator it=SortArray.begin()+first;
+		inplace_merge(it,it+width,it+std::min(2*width,size-first),ObjectSortByRadius());
+	}
+}
+
 void cCamera::DrawSortObject()
 {
 	camerapass=SCENENODE_OBJECTSORT;
@@ -686,7 +722,7 @@ void cCamera::DrawSortObject()
 //	RenderDevice->SetRenderState(RS_ZFUNC,CMP_LESSEQUAL);
 //	RenderDevice->SetRenderState( RS_CULLMODE, D3DCULL_NONE );
 
-	stable_sort(SortArray.begin(),SortArray.end(),ObjectSortByRadius());
+	SortObjects();
 
     uint32_t fogenable = RenderDevice->GetRenderState(RS_FOGENABLE);
 	RenderDevice->SetRenderState(RS_FOGENABLE, false);
@@ -1061,6 +1097,57 @@ eTestVisible cCamera::TestVisible(const MatXf &matrix,const Vect3f &min,const Ve
 	return VISIBLE_INTERSECT;
 }
 
+eTestVisible cCamera::GridTestBound(const Vect3f &min,const Vect3f &max)
+{
+	const float lim=1e9f;
+	int x0=(int) xm::round(clamp(min.x,-lim,lim)) >> TestGridShl,y0=(int) xm::round(clamp(min.y,-lim,lim)) >> TestGridShl;
+	int x1=(int) xm::round(clamp(max.x,-lim,lim)) >> TestGridShl,y1=(int) xm::round(clamp(max.y,-lim,lim)) >> TestGridShl;
+
+	//Углы вне сетки GridTest пропускает, поэтому целиком видим только бокс внутри сетки
+	eTestVisible result=VISIBLE_INSIDE;
+	if(x0<0) x0=0,result=VISIBLE_INTERSECT;
+	if(y0<0) y0=0,result=VISIBLE_INTERSECT;
+	if(x1>=TestGridSize.x) x1=TestGridSize.x-1,result=VISIBLE_INTERSECT;
+	if(y1>=TestGridSize.y) y1=TestGridSize.y-1,result=VISIBLE_INTERSECT;
+	if(x0>x1 || y0>y1)
+		return VISIBLE_OUTSIDE;
+
+	bool any=false;
+	for(int y=y0;y<=y1;y++)
+	for(int x=x0;x<=x1;x++)
+	{
+		if(pTestGrid[x+y*TestGridSize.x])
+			any=true;
+		else
+			result=VISIBLE_INTERSECT;
+		if(any && result==VISIBLE_INTERSECT)
+			return VISIBLE_INTERSECT;
+	}
+
+	return any?result:VISIBLE_OUTSIDE;
+}
+
+eTestVisible cCamera::TestVisibleBound(const Vect3f &min,const Vect3f &max)
+{
+	if(RootCamera->pTestGrid)
+		return RootCamera->GridTestBound(min,max);
+
+	//Запас на погрешность, бокс считается не из тех же точек, что и у объектов
+	const float eps=0.1f;
+	eTestVisible result=VISIBLE_INSIDE;
+	for(int i=0;i<GetNumberPlaneClip3d();i++)
+	{
+		sPlane4f& p=GetPlaneClip3d(i);
+		Vect3f far_point(p.A>=0?max.x:min.x,p.B>=0?max.y:min.y,p.C>=0?max.z:min.z);
+		if(p.GetDistance(far_point)<-eps)
+			return VISIBLE_OUTSIDE;
+		Vect3f near_point(p.A>=0?min.x:max.x,p.B>=0?min.y:max.y,p.C>=0?min.z:max.z);
+		if(p.GetDistance(near_point)<eps)
+			result=VISIBLE_INTERSECT;
+	}
+	return result;
+}
+
 //*
 eTestVisible cCamera::TestVisible(const Vect3f &min,const Vect3f &max)
 { // для BoundingBox с границами min && max, заданными в глобальным координатах
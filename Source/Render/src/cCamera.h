@@ -103,6 +103,10 @@ public:
 	
 	eTestVisible TestVisible(const MatXf &matrix,const Vect3f &min,const Vect3f &max);
 	inline eTestVisible TestVisible(const Vect3f &center,float radius=0);
+	//Для группы объектов с общим боксом в глобальных координатах.
+	//VISIBLE_OUTSIDE и VISIBLE_INSIDE только если TestVisible(matrix,min,max)
+	//для любого объекта внутри бокса даст соответственно 0 и не 0
+	eTestVisible TestVisibleBound(const Vect3f &min,const Vect3f &max);
 
 	void Attach(int pos,cIUnkClass *UObject);
 	inline void Attach(int pos,cIUnkClass *UObject,const MatXf &m,const Vect3f &min,const Vect3f &max);
@@ -223,6 +227,7 @@ protected:
 
 	eSceneNode camerapass;
 	void DrawSortObject();
+	void SortObjects();
 	void DrawObjectFirst();
 
 	Vect2i TestGridSize;
@@ -231,6 +236,7 @@ protected:
 	void InitGridTest(int grid_dx,int grid_dy,int grid_size);
 	void CalcTestForGrid();
 	inline eTestVisible GridTest(Vect3f p[8]);
+	eTestVisible GridTestBound(const Vect3f &min,const Vect3f &max);
 
 	void DrawShadowDebug();
 	void Set2DRenderState();
@@ -33,4 +33,39 @@ inline char* GetKey(const void *buf,int size,char *key)
 }
 inline const char* isGroupName(const char *name)				{ return TestFirstName(name,"group "); }
 
+//Индекс имён подобъектов для поиска без учёта регистра.
+//Find возвращает наименьший номер, имя которого совпадает по stricmp, или -1
+class cNameIndex
+{
+	std::vector<std::pair<uint32_t,int> > items;//(хэш, номер) по возрастанию
+public:
+	static uint32_t Hash(const char* name)
+	{
+		uint32_t hash=2166136261u;
+		for(;*name;name++)
+			hash=(hash^(uint8_t)tolower((uint8_t)*name))*16777619u;
+		return hash;
+	}
+
+	void Clear() { items.clear(); }
+	void Add(const char* name,int number)
+	{
+		std::pair<uint32_t,int> item(Hash(name),number);
+		items.insert(std::upper_bound(items.begin(),items.end(),item),item);
+	}
+
+	//get_name(number) - имя объекта с этим номером
+	template<class GetName>
+	int Find(const char* name,GetName get_name) const
+	{
+		uint32_t hash=Hash(name);
+		std::vector<std::pair<uint32_t,int> >::const_iterator it;
+		it=std::lower_bound(items.begin(),items.end(),std::make_pair(hash,-1));
+		for(;it!=items.end() && it->first==hash;++it)
+			if(stricmp(get_name(it->second),name)==0)
+				return it->second;
+		return -1;
+	}
+};
+
 #endif //__UTIL_H__
\ No newline at end of file
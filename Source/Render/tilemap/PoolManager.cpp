@@ -144,6 +144,13 @@ VertexBuffer* VertexPoolManager::GetBuffer(const VertexPoolPage& page) {
     return pool->buffers[page.page];
 }
 
+size_t VertexPoolManager::GetPageBytes(const VertexPoolPage& page)
+{
+	CheckGood(page);
+	VertexPool* pool = safe_cast<VertexPool*>(pools[page.pool]);
+	return pool->page_size * pool->vertex_size;
+}
+
 void* VertexPoolManager::LockPage(const VertexPoolPage& page)
 {
 	CheckGood(page);
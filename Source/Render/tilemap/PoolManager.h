@@ -123,6 +123,7 @@ protected:
     Pool* NewPool() override { return new VertexPool(); }
 public:
     VertexBuffer* GetBuffer(const VertexPoolPage& page);
+    size_t GetPageBytes(const VertexPoolPage& page);
 	void* LockPage(const VertexPoolPage& page);
 	void UnlockPage(const VertexPoolPage& page);
 };
@@ -345,6 +345,60 @@ void cTileMap::Draw(cCamera *DrawNode)
 	DrawLines();
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// реализация cTileMapMaxMip
+//////////////////////////////////////////////////////////////////////////////////////////
+void cTileMapMaxMip::SetSize(const Vect2i& size_)
+{
+	size=size_;
+	levels.clear();
+	for(int level=1;(size.x>>(level-1))>1 || (size.y>>(level-1))>1;level++)
+	{
+		sLevel l;
+		l.size.set(max((size.x+(1<<level)-1)>>level,1),max((size.y+(1<<level)-1)>>level,1));
+		l.z.assign(l.size.x*l.size.y,0);
+		levels.push_back(l);
+	}
+}
+
+void cTileMapMaxMip::Update(TerraInterface* terra, const Vect2i& pos1, const Vect2i& pos2)
+{
+	if(levels.empty())
+		return;
+
+	int x1=max(pos1.x,0),y1=max(pos1.y,0);
+	int x2=min(pos2.x,size.x-1),y2=min(pos2.y,size.y-1);
+	if(x1>x2 || y1>y2)
+		return;
+
+	for(int level=1;level<=levels.size();level++)
+	{
+		x1>>=1;y1>>=1;
+		x2>>=1;y2>>=1;
+		sLevel& l=levels[level-1];
+		for(int y=y1;y<=y2;y++)
+		for(int x=x1;x<=x2;x++)
+		{
+			int zmax=0;
+			if(level==1)
+			{
+				int xe=min(2*x+2,size.x),ye=min(2*y+2,size.y);
+				for(int yy=2*y;yy<ye;yy++)
+				for(int xx=2*x;xx<xe;xx++)
+					zmax=max(zmax,terra->GetZ(xx,yy));
+			}else
+			{
+				const sLevel& prev=levels[level-2];
+				int xe=min(2*x+2,prev.size.x),ye=min(2*y+2,prev.size.y);
+				for(int yy=2*y;yy<ye;yy++)
+				for(int xx=2*x;xx<xe;xx++)
+					zmax=max(zmax,(int)prev.z[xx+yy*prev.size.x]);
+			}
+			l.z[x+y*l.size.x]=min(zmax,255);
+		}
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // реализация cTileMap
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -356,6 +410,8 @@ void cTileMap::UpdateMap(const Vect2i& pos1,const Vect2i& pos2)
 	rc.p2=pos2;
 	update_rect.push_back(rc);
 
+	max_mip.Update(terra,pos1,pos2);
+
 	if(enable_debug_rect)
 	{
 		DebugRect rc;
@@ -393,6 +449,8 @@ void cTileMap::SetBuffer(const Vect2i &size,int zeroplastnumber_)
 	Tile = new sTile[GetTileNumber().x*GetTileNumber().y];
 	gb_RenderDevice->CreateTilemap(this);
 
+	max_mip.SetSize(size);
+
 	UpdateMap(Vect2i(0,0), Vect2i(size.x-1,size.y-1));
 }
 
@@ -919,6 +977,9 @@ void cTileMap::BuildRegionPoint()
 			for(int i=i1;i<=i2;i++)
 			{
 				sTile& p=GetTile(i,j);
+				Vect2s pmin(max(pos1.x-i*dx,0),max(pos1.y-j*dy,0));
+				Vect2s pmax(min(pos2.x-i*dx,dx-1),min(pos2.y-j*dy,dy-1));
+				p.AddUpdateRect(pmin,pmax);
 				p.SetAttribute(ATTRTILE_UPDATELOD|ATTRTILE_UPDATE_POINT);
 				p.region_point.clear();
 				p.region_point.resize(zeroplastnumber);
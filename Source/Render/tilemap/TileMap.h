@@ -21,6 +21,8 @@ struct sTile : public sAttribute
 {
 	int bumpTileID;
 	uint8_t zmin,zmax;
+	//Changed area in tile local coordinates, valid while update is set
+	Vect2s update_min,update_max;
 
 	std::vector<std::vector<Vect2s> > region_point;//region_point[player][point]
 
@@ -36,6 +38,45 @@ struct sTile : public sAttribute
 
 	inline void ClearDraw()			{ ClearAttribute(ATTRTILE_DRAWLOD); }
 	inline void ClearUpdate()		{ ClearAttribute(ATTRTILE_UPDATELOD); }
+
+	void AddUpdateRect(const Vect2s& pmin, const Vect2s& pmax)
+	{
+		if(GetUpdate())
+		{
+			update_min.set(min(update_min.x,pmin.x),min(update_min.y,pmin.y));
+			update_max.set(max(update_max.x,pmax.x),max(update_max.y,pmax.y));
+		}else
+		{
+			update_min=pmin;
+			update_max=pmax;
+		}
+	}
+};
+
+//Пирамида максимальных высот для трассировки лучей по карте высот.
+//Уровень level хранит максимум по блоку (1<<level)x(1<<level),
+//нулевой уровень не хранится - это сама карта высот
+class cTileMapMaxMip
+{
+public:
+	void SetSize(const Vect2i& size);
+	//Пересчитывает блоки, задевающие изменившийся прямоугольник
+	void Update(TerraInterface* terra, const Vect2i& pos1, const Vect2i& pos2);
+
+	int GetLevels() const { return levels.size(); }
+	int GetMax(int level, int x, int y) const
+	{
+		const sLevel& l=levels[level-1];
+		return l.z[x+y*l.size.x];
+	}
+protected:
+	struct sLevel
+	{
+		Vect2i size;
+		std::vector<uint8_t> z;
+	};
+	Vect2i size;
+	std::vector<sLevel> levels;
 };
 
 typedef std::vector<std::vector<Vect2s>* > CurrentRegion;
@@ -63,6 +104,7 @@ class cTileMap : public cUnkObj
 
 	std::vector<Column*> columns;
 	class TerraInterface* terra;
+	cTileMapMaxMip max_mip;
 
 	struct UpdateRect
 	{
@@ -126,6 +168,7 @@ public:
 	cTileMapRender* GetTilemapRender(){return pTileMapRender;}
 
 	TerraInterface* GetTerra(){return terra;}
+	const cTileMapMaxMip& GetMaxMip() const {return max_mip;}
 
 	Vect2f CalcZ(cCamera *DrawNode);
 	void DrawLightmapShadow(cCamera *DrawNode);
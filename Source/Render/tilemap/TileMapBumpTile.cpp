@@ -88,36 +88,57 @@ inline int IUCLAMP(int val,int clamp)
     return val;
 }
 
-void sBumpTile::CalcTexture()
+void sBumpTile::CalcTexture(const Vect2i& tex_pos, const Vect2i& tex_size)
 {
-    int tilex = tilemap->GetTileSize().x;
-    int tiley = tilemap->GetTileSize().y;
-    int xStart = tile_pos.x * tilex;
-    int yStart = tile_pos.y * tiley;
-    int xFinish = xStart + tilex;
-    int yFinish = yStart + tiley;
-    int Pitch = 0;
-    uint8_t* texRect = LockTex(Pitch);
+    int xStart = tile_pos.x * tilemap->GetTileSize().x;
+    int yStart = tile_pos.y * tilemap->GetTileSize().y;
     int dd = 1 << bumpTexScale[LOD];
-
-    TerraInterface* terra = tilemap->GetTerra();
-    terra->GetTileColor(
-            texRect,
-            Pitch,
-            xStart - cTilemapTexturePool::TEXTURE_BORDER * dd,
-            yStart - cTilemapTexturePool::TEXTURE_BORDER * dd,
-            xFinish + cTilemapTexturePool::TEXTURE_BORDER * dd,
-            yFinish + cTilemapTexturePool::TEXTURE_BORDER * dd,
-            dd
-    );
+    //Page texel 0 starts border before tile
+    xStart += (tex_pos.x - cTilemapTexturePool::TEXTURE_BORDER) * dd;
+    yStart += (tex_pos.y - cTilemapTexturePool::TEXTURE_BORDER) * dd;
+    int Pitch = 0;
+    uint8_t* texRect = static_cast<uint8_t*>(texPool->lockPageRect(texPage, Pitch, tex_pos, tex_size));
+    if (texRect) {
+        TerraInterface* terra = tilemap->GetTerra();
+        terra->GetTileColor(
+                texRect,
+                Pitch,
+                xStart,
+                yStart,
+                xStart + tex_size.x * dd,
+                yStart + tex_size.y * dd,
+                dd
+        );
+    }
 
     UnlockTex();
 }
 
+void sBumpTile::GetTextureRect(const Vect2s& pmin, const Vect2s& pmax, Vect2i& tex_pos, Vect2i& tex_size)
+{
+    //Changed texels are widened by border, so border of neighbour tiles changes are also caught
+    int shl = bumpTexScale[LOD];
+    int w = texPool->GetPageWidth();
+    int h = texPool->GetPageHeight();
+    int x1 = max(pmin.x >> shl, 0);
+    int y1 = max(pmin.y >> shl, 0);
+    int x2 = min((pmax.x >> shl) + 2 * cTilemapTexturePool::TEXTURE_BORDER, w - 1);
+    int y2 = min((pmax.y >> shl) + 2 * cTilemapTexturePool::TEXTURE_BORDER, h - 1);
+    tex_pos.set(x1, y1);
+    tex_size.set(x2 - x1 + 1, y2 - y1 + 1);
+}
+
 void sBumpTile::Calc(bool update_texture)
 {
     if(update_texture)
-        CalcTexture();
+        CalcTexture(Vect2i(0, 0), Vect2i(texPool->GetPageWidth(), texPool->GetPageHeight()));
+    CalcPoint();
+    init = true;
+}
+
+void sBumpTile::CalcRect(const Vect2i& tex_pos, const Vect2i& tex_size)
+{
+    CalcTexture(tex_pos, tex_size);
     CalcPoint();
     init = true;
 }
@@ -77,6 +77,10 @@ public:
     void UnlockTex();
     void UnlockVB();
     void Calc(bool update_texture);
+    //Updates only texture page area, see GetTextureRect
+    void CalcRect(const Vect2i& tex_pos, const Vect2i& tex_size);
+    //Texture page area in texels which covers changed tile area, borders included
+    void GetTextureRect(const Vect2s& pmin, const Vect2s& pmax, Vect2i& tex_pos, Vect2i& tex_size);
 
     void FindFreeTexture(int& Pool,int& Page,int tex_width,int tex_height);
 
@@ -102,7 +106,7 @@ public:
         return index.size()==1 && index[0].player>=0;
     }
 protected:
-    void CalcTexture();
+    void CalcTexture(const Vect2i& tex_pos, const Vect2i& tex_size);
     void CalcPoint();
 
     int FixLine(VectDelta* points, int ddv);
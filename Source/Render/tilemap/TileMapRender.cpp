@@ -44,6 +44,7 @@ cTileMapRender::cTileMapRender(cTileMap *pTileMap)
     update_stat=NULL;
 //	update_stat=new char[dxy*TILEMAP_LOD];
     update_in_frame=false;
+    update_cursor=0;
 
     int ddv=TILEMAP_SIZE+1;
     delta_buffer=new VectDelta[ddv*ddv];
@@ -255,60 +256,152 @@ void cTileMapRender::CalcTileMap(cCamera* DrawNode) {
 
 //stop_timer(Calc_TileMap, 1);
 
+    //Changed tiles are recalculated within budget, scan starts from first tile deferred in previous frame
+    sTileUpdateBudget budget(TILEMAP_UPDATE_BUDGET);
+    int total_tiles = dn * dk;
+
     tilemap->GetTerra()->LockColumn();
-    for (n = 0; n < dn; n++) {
-        for (k = 0; k < dk; k++) {
-            sTile& Tile = tilemap->GetTile(k, n);
-            int bumpTileID = Tile.bumpTileID;
-            if (bumpTileID < 0)continue;
-            sBumpTile* bumpTile = bumpTiles[bumpTileID];
-            int LOD = bumpTile->LOD;
-            bool update_line = false;
-            if (k > 0) {
-                char lod = vis_lod[k - 1 + n * dk];
-                char& cur_lod = bumpTile->border_lod[sBumpTile::U_LEFT];
-                if (lod >= LOD && cur_lod != lod) {
-                    cur_lod = lod;
-                    update_line = true;
-                }
+    for (int t = 0; t < total_tiles; t++) {
+        int tile_index = (update_cursor + t) % total_tiles;
+        k = tile_index % dk;
+        n = tile_index / dk;
+        sTile& Tile = tilemap->GetTile(k, n);
+        int bumpTileID = Tile.bumpTileID;
+        if (bumpTileID < 0)continue;
+        sBumpTile* bumpTile = bumpTiles[bumpTileID];
+        int LOD = bumpTile->LOD;
+        bool update_line = false;
+        if (k > 0) {
+            char lod = vis_lod[k - 1 + n * dk];
+            char& cur_lod = bumpTile->border_lod[sBumpTile::U_LEFT];
+            if (lod >= LOD && cur_lod != lod) {
+                cur_lod = lod;
+                update_line = true;
             }
+        }
 
-            if (k < dk - 1) {
-                char lod = vis_lod[k + 1 + n * dk];
-                char& cur_lod = bumpTile->border_lod[sBumpTile::U_RIGHT];
-                if (lod >= LOD && cur_lod != lod) {
-                    cur_lod = lod;
-                    update_line = true;
-                }
+        if (k < dk - 1) {
+            char lod = vis_lod[k + 1 + n * dk];
+            char& cur_lod = bumpTile->border_lod[sBumpTile::U_RIGHT];
+            if (lod >= LOD && cur_lod != lod) {
+                cur_lod = lod;
+                update_line = true;
             }
+        }
 
-            if (n > 0) {
-                char lod = vis_lod[k + (n - 1) * dk];
-                char& cur_lod = bumpTile->border_lod[sBumpTile::U_TOP];
-                if (lod >= LOD && cur_lod != lod) {
-                    cur_lod = lod;
-                    update_line = true;
-                }
+        if (n > 0) {
+            char lod = vis_lod[k + (n - 1) * dk];
+            char& cur_lod = bumpTile->border_lod[sBumpTile::U_TOP];
+            if (lod >= LOD && cur_lod != lod) {
+                cur_lod = lod;
+                update_line = true;
             }
+        }
 
-            if (n < dn - 1) {
-                char lod = vis_lod[k + (n + 1) * dk];
-                char& cur_lod = bumpTile->border_lod[sBumpTile::U_BOTTOM];
-                if (lod >= LOD && cur_lod != lod) {
-                    cur_lod = lod;
-                    update_line = true;
-                }
+        if (n < dn - 1) {
+            char lod = vis_lod[k + (n + 1) * dk];
+            char& cur_lod = bumpTile->border_lod[sBumpTile::U_BOTTOM];
+            if (lod >= LOD && cur_lod != lod) {
+                cur_lod = lod;
+                update_line = true;
             }
+        }
 
-            if ((!bumpTile->init) || Tile.GetUpdate() || update_line) {
-                bumpTile->Calc(!bumpTile->init || Tile.GetUpdate());
+        if (!bumpTile->init) {
+            //New tile must be drawn at once, but still eats budget
+            size_t bytes = GetVertexPool()->GetPageBytes(bumpTile->vtx)
+                    + bumpTile->texPool->GetPageWidth() * bumpTile->texPool->GetPageHeight() * sizeof(uint32_t);
+            bumpTile->Calc(true);
+            budget.Force(bytes);
+            Tile.ClearUpdate();
+        } else if (Tile.GetUpdate()) {
+            Vect2i tex_pos, tex_size;
+            bumpTile->GetTextureRect(Tile.update_min, Tile.update_max, tex_pos, tex_size);
+            size_t bytes = GetVertexPool()->GetPageBytes(bumpTile->vtx)
+                    + static_cast<size_t>(tex_size.x) * tex_size.y * sizeof(uint32_t);
+            if (budget.Take(tile_index, bytes)) {
+                bumpTile->CalcRect(tex_pos, tex_size);
                 Tile.ClearUpdate();
+            } else {
+                //Keep update flag and rect for next frame
+                if (update_line) {
+                    bumpTile->Calc(false);
+                }
             }
-
+        } else if (update_line) {
+            bumpTile->Calc(false);
         }
     }
     
     tilemap->GetTerra()->UnlockColumn();
+    update_cursor = budget.NextCursor();
+}
+
+//Same scan as in CalcTileMap over tiles where only update flags and their size are known,
+//dirty[i] is 0 for clean tile
+static int RunTileUpdateBudget(std::vector<size_t>& dirty, int& cursor, size_t budget_bytes, int& deferred) {
+    sTileUpdateBudget budget(budget_bytes);
+    int total_tiles = static_cast<int>(dirty.size());
+    int updated = 0;
+    for (int t = 0; t < total_tiles; t++) {
+        int tile_index = (cursor + t) % total_tiles;
+        if (dirty[tile_index] && budget.Take(tile_index, dirty[tile_index])) {
+            dirty[tile_index] = 0;
+            updated++;
+        }
+    }
+    cursor = budget.NextCursor();
+    deferred = budget.deferred;
+    return updated;
+}
+
+bool cInterfaceRenderDevice::CheckTileUpdateBudget() {
+    const int total_tiles = 16;
+    const size_t tile_bytes = 100;
+    //Three tiles fit per frame
+    const size_t budget_bytes = tile_bytes * 3 + tile_bytes / 2;
+    bool ok = true;
+
+    //All tiles changed at once are spread over frames, nothing is lost
+    std::vector<size_t> dirty(total_tiles, tile_bytes);
+    int cursor = 0;
+    int deferred = 0;
+    int left = total_tiles;
+    int frames = 0;
+    while (left) {
+        int updated = RunTileUpdateBudget(dirty, cursor, budget_bytes, deferred);
+        ok &= updated == std::min(left, 3) && deferred == left - updated;
+        left -= updated;
+        if (total_tiles < ++frames) {
+            ok = false;
+            break;
+        }
+    }
+    ok &= frames == (total_tiles + 2) / 3;
+
+    //Tile changed every frame doesn't starve the rest, deferred ones go first next frame
+    dirty.assign(total_tiles, tile_bytes);
+    cursor = 0;
+    frames = 0;
+    while (std::count(dirty.begin() + 1, dirty.end(), 0) < total_tiles - 1) {
+        dirty[0] = tile_bytes;
+        RunTileUpdateBudget(dirty, cursor, budget_bytes, deferred);
+        if (total_tiles < ++frames) {
+            ok = false;
+            break;
+        }
+    }
+
+    //Tile bigger than whole budget still goes, alone
+    dirty.assign(total_tiles, 0);
+    dirty[2] = budget_bytes * 2;
+    dirty[5] = tile_bytes;
+    cursor = 0;
+    int updated = RunTileUpdateBudget(dirty, cursor, budget_bytes, deferred);
+    ok &= updated == 1 && dirty[2] == 0 && deferred == 1 && cursor == 5;
+
+    printf("CheckTileUpdateBudget: %d frames for %d tiles, %s\n", frames, total_tiles, ok ? "ok" : "failed");
+    return ok;
 }
 
 int cTileMapRender::bumpNumVertices(int lod) {
@@ -2,9 +2,44 @@
 #define PERIMETER_TILEMAPRENDER_H
 
 struct sBumpTile;
+
+const size_t TILEMAP_UPDATE_BUDGET = 512 * 1024;
 class cTilemapTexturePool;
 struct VectDelta;
 
+//Decides which changed tiles are recalculated in this frame, rest keep update flag for next ones
+struct sTileUpdateBudget
+{
+    size_t left;
+    size_t used = 0;
+    int deferred = 0;
+    //First deferred tile, next frame scan starts here so terraforming can't starve part of map
+    int first_deferred = -1;
+
+    explicit sTileUpdateBudget(size_t budget) : left(budget) {}
+
+    //New tile must be drawn at once, but still eats budget
+    void Force(size_t bytes) {
+        left -= std::min(left, bytes);
+        used += bytes;
+    }
+
+    //First tile always passes, otherwise tile bigger than budget would never update
+    bool Take(int tile_index, size_t bytes) {
+        if (bytes <= left || used == 0) {
+            Force(bytes);
+            return true;
+        }
+        if (first_deferred < 0) {
+            first_deferred = tile_index;
+        }
+        deferred++;
+        return false;
+    }
+
+    int NextCursor() const { return first_deferred < 0 ? 0 : first_deferred; }
+};
+
 class cTileMapRender
 {
 private:
@@ -24,6 +59,9 @@ private:
     char* update_stat;
     bool update_in_frame;
 
+    //First tile to scan for changes, see sTileUpdateBudget
+    int update_cursor;
+
     void SaveUpdateStat();
 
     VectDelta* delta_buffer;
@@ -66,8 +66,13 @@ void cTilemapTexturePool::freePage(int page) {
 }
 
 void* cTilemapTexturePool::lockPage(int page, int& Pitch) {
-    Vect2i pos=Pages[page];
-    return gb_RenderDevice->LockTextureRect(texture, Pitch, pos, { tileRealWidth, tileRealHeight });
+    return lockPageRect(page, Pitch, Vect2i(0, 0), Vect2i(tileRealWidth, tileRealHeight));
+}
+
+void* cTilemapTexturePool::lockPageRect(int page, int& Pitch, const Vect2i& pos, const Vect2i& size) {
+    VISASSERT(0 <= pos.x && pos.x + size.x <= tileRealWidth);
+    VISASSERT(0 <= pos.y && pos.y + size.y <= tileRealHeight);
+    return gb_RenderDevice->LockTextureRect(texture, Pitch, Pages[page] + pos, size);
 }
 
 void cTilemapTexturePool::unlockPage(int page)
@@ -21,6 +21,8 @@ public:
     int allocPage();
     void freePage(int page);
     void* lockPage(int page, int& Pitch);
+    //pos and size are relative to page including border
+    void* lockPageRect(int page, int& Pitch, const Vect2i& pos, const Vect2i& size);
     void unlockPage(int page);
     Vect2f getUVStart(int page);
     inline float getVStep(){return vstep;};
@@ -28,6 +30,8 @@ public:
 
     inline int GetTileWidth(){return tileWidth;}
     inline int GetTileHeight(){return tileHeight;}
+    inline int GetPageWidth(){return tileRealWidth;}
+    inline int GetPageHeight(){return tileRealHeight;}
     inline bool IsFree(){return 0 < freePages;}
     inline cTexture* GetTexture() { return texture; }
 
@@ -187,6 +187,9 @@ vrtMap::vrtMap() {
 
 	gridChAreas = NULL;
 	gridChAreas2 = NULL;
+	gridRevision = NULL;
+	gridRevisionCounter = 0;
+	gridRevisionAll = 0;
 
 	pTempArray=NULL;
 
@@ -251,6 +254,7 @@ vrtMap::~vrtMap(void)
 	if(changedT) { delete[] changedT; changedT = NULL; }
 	if(gridChAreas) { delete [] gridChAreas; gridChAreas = NULL; }
 	if(gridChAreas2) { delete [] gridChAreas2; gridChAreas2 = NULL;}
+	if(gridRevision) { delete [] gridRevision; gridRevision = NULL; }
 
 	delLeveledTexture();//Необходимо вызывать до удаления VxDBuf !
 	if(VxGBuf!=0) releaseMem4Buf();
@@ -582,6 +586,7 @@ void vrtMap::releaseChAreaBuf()
 
 	if(gridChAreas) { delete [] gridChAreas; gridChAreas=0; }
 	if(gridChAreas2) { delete [] gridChAreas2; gridChAreas2=0; }
+	if(gridRevision) { delete [] gridRevision; gridRevision=0; }
 }
 
 void vrtMap::allocChAreaBuf()
@@ -593,6 +598,9 @@ void vrtMap::allocChAreaBuf()
 	gridChAreas= new unsigned char[sizeGCA];
 	gridChAreas2= new unsigned char[sizeGCA];
 	clearGridChangedAreas();
+	gridRevision= new unsigned int[sizeGCA];
+	memset(gridRevision, 0, sizeGCA*sizeof(*gridRevision));
+	changedGridAll();
 }
 
 
@@ -767,6 +775,7 @@ void vrtMap::loadHardness2Grid(void)
 			//Sum>>6 приведение от 0-255 к диапазону 0-3
 		}
 	}
+	changedGridAll();
 
 	delete [] HDNBuf;
 }
@@ -802,6 +811,7 @@ void vrtMap::loadHardness(void)
 			}
 			yOffsetHBuf+=width;
 		}
+		changedGridAll();
 
 		delete [] HDNBuf;
 		ff.close();
@@ -851,6 +861,41 @@ void vrtMap::clearGridChangedAreas(void)
 	memset(gridChAreas2, 0, sizeGCA*sizeof(*gridChAreas));
 }
 
+void vrtMap::changedGrid(int xg0, int yg0, int xg1, int yg1)
+{
+	if(!gridRevision) return;
+	unsigned int revision = ++gridRevisionCounter;
+	const int shift = kmGridChA - kmGrid;
+	const int hSizeGCA = H_SIZE >> kmGridChA;
+	const int vSizeGCA = V_SIZE >> kmGridChA;
+	xg0 = XCYCLG(xg0); yg0 = YCYCLG(yg0);
+	int nx = std::min( ( (xg0 & ((1<<shift)-1)) + XCYCLG(xg1 - xg0) ) >> shift, hSizeGCA-1) + 1;
+	int ny = std::min( ( (yg0 & ((1<<shift)-1)) + YCYCLG(yg1 - yg0) ) >> shift, vSizeGCA-1) + 1;
+	for(int j = 0; j < ny; j++){
+		unsigned int* row = gridRevision + ( ((yg0 >> shift) + j) & (vSizeGCA-1) ) * hSizeGCA;
+		for(int i = 0; i < nx; i++)
+			row[((xg0 >> shift) + i) & (hSizeGCA-1)] = revision;
+	}
+}
+
+unsigned int vrtMap::getGridRevision(int xg0, int yg0, int xg1, int yg1)
+{
+	unsigned int revision = gridRevisionAll;
+	if(!gridRevision) return revision;
+	const int shift = kmGridChA - kmGrid;
+	const int hSizeGCA = H_SIZE >> kmGridChA;
+	const int vSizeGCA = V_SIZE >> kmGridChA;
+	xg0 = XCYCLG(xg0); yg0 = YCYCLG(yg0);
+	int nx = std::min( ( (xg0 & ((1<<shift)-1)) + XCYCLG(xg1 - xg0) ) >> shift, hSizeGCA-1) + 1;
+	int ny = std::min( ( (yg0 & ((1<<shift)-1)) + YCYCLG(yg1 - yg0) ) >> shift, vSizeGCA-1) + 1;
+	for(int j = 0; j < ny; j++){
+		const unsigned int* row = gridRevision + ( ((yg0 >> shift) + j) & (vSizeGCA-1) ) * hSizeGCA;
+		for(int i = 0; i < nx; i++)
+			revision = std::max(revision, row[((xg0 >> shift) + i) & (hSizeGCA-1)]);
+	}
+	return revision;
+}
+
 void vrtMap::updateGridChangedAreas2(void)
 {
 	int sizeGCA=(V_SIZE>>kmGridChA)*(H_SIZE>>kmGridChA);
@@ -203,12 +203,22 @@ struct vrtMap {
 	std::list<sRectS> changedAreas;
 	unsigned char* gridChAreas;
 	unsigned char* gridChAreas2;
+	//Ревизии изменений GABuf по блокам gridChAreas, чтобы кэшировать посчитанное по сетке
+	unsigned int* gridRevision;
+	unsigned int gridRevisionCounter;
+	unsigned int gridRevisionAll;
 
 	std::list<sRectS> renderAreas;
 
 ///////////////////////////////////////////////////////////////////
 	std::list<sPreChangedArea> preCAs;
 	std::list<sPreChangedArea>::iterator curPreCA;
+	sUndoArena undoArena;
+	std::vector<unsigned char> undoRaw, undoCur, undoPacked;
+	bool UndoDispatcher_Store(sPreChangedArea& area, int packedSize);
+	void UndoDispatcher_Gather(const sPreChangedArea& area, unsigned char* dst);
+	void UndoDispatcher_FinishLast(void);
+	void UndoDispatcher_Apply(sPreChangedArea& area);
 	void UndoDispatcher_PutPreChangedArea(int xL, int yT, int xR, int yB);
 	void UndoDispatcher_Undo(void);
 	void UndoDispatcher_Redo(void);
@@ -306,10 +316,15 @@ struct vrtMap {
 	}
 	void setHardness(int xg, int yg, unsigned char hrd){
 		GABuf[offsetGBuf(xg, yg)]=(hrd&GRIDAT_MASK_HARDNESS) | (GABuf[offsetGBuf(xg, yg)]&(~GRIDAT_MASK_HARDNESS)) ;
+		changedGrid(xg, yg, xg, yg);
 	}
 
 	void clearGridChangedAreas(void);
 	void updateGridChangedAreas2(void);
+	//Координаты сетки включительно, циклятся
+	void changedGrid(int xg0, int yg0, int xg1, int yg1);
+	void changedGridAll(void){ gridRevisionAll = ++gridRevisionCounter; }
+	unsigned int getGridRevision(int xg0, int yg0, int xg1, int yg1);
 
 
 	unsigned short Sur2Col[MAX_SURFACE_TYPE][MAX_SURFACE_LIGHTING*2]; //2 это два слоя Dam и ZP
@@ -607,7 +622,10 @@ struct vrtMap {
 		int x=_x>>kmGrid;
 		int y=_y>>kmGrid;
 		int offG=offsetGBuf(XCYCLG(x), YCYCLG(y));
-		if(GABuf[offG]&GRIDAT_BUILDING) GABuf[offG]|=GRIDAT_BASE_OF_BUILDING_CORRUPT;
+		if(GABuf[offG]&GRIDAT_BUILDING){
+			GABuf[offG]|=GRIDAT_BASE_OF_BUILDING_CORRUPT;
+			changedGrid(x, y, x, y);
+		}
 	}
 
 
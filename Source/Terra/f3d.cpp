@@ -27,6 +27,7 @@ s_f3d::s_f3d(void)
 	kmx=200.; kmy=200.; kmz=200;
 	#ifdef _TX3D_LIBRARY_
 		indexedTexture = 0;
+		brickHead = brickTail = -1;
 	#endif
 }
 
@@ -37,6 +38,77 @@ s_f3d::~s_f3d() {
 		indexedTexture = 0;
 	}
 }
+
+void s_f3d::clearBrickCache()
+{
+	bricks.clear();
+	brickMap.clear();
+	brickHead = brickTail = -1;
+}
+
+void s_f3d::unlinkBrick(int b)
+{
+	sBrick& brick = bricks[b];
+	if(brick.prev >= 0) bricks[brick.prev].next = brick.next;
+	else brickHead = brick.next;
+	if(brick.next >= 0) bricks[brick.next].prev = brick.prev;
+	else brickTail = brick.prev;
+}
+
+void s_f3d::pushFrontBrick(int b)
+{
+	sBrick& brick = bricks[b];
+	brick.prev = -1;
+	brick.next = brickHead;
+	if(brickHead >= 0) bricks[brickHead].prev = b;
+	brickHead = b;
+	if(brickTail < 0) brickTail = b;
+}
+
+int s_f3d::calcCached(int x, int y, int z)
+{
+	uint64_t key = ((uint64_t)(uint32_t)(x >> F3D_BRICK_SHIFT) << 42)
+		| ((uint64_t)((uint32_t)(y >> F3D_BRICK_SHIFT) & 0x1FFFFF) << 21)
+		| ((uint32_t)(z >> F3D_BRICK_SHIFT) & 0x1FFFFF);
+	int b;
+	std::unordered_map<uint64_t, int>::iterator it = brickMap.find(key);
+	if(it == brickMap.end()){
+		if(bricks.size() < F3D_BRICK_CACHE_SIZE){
+			if(bricks.empty()) bricks.reserve(F3D_BRICK_CACHE_SIZE);
+			bricks.push_back(sBrick());
+			b = (int)bricks.size() - 1;
+		}
+		else {
+			b = brickTail;
+			unlinkBrick(b);
+			brickMap.erase(bricks[b].key);
+		}
+		sBrick& brick = bricks[b];
+		brick.key = key;
+		memset(brick.valid, 0, sizeof(brick.valid));
+		brickMap[key] = b;
+		pushFrontBrick(b);
+	}
+	else {
+		b = it->second;
+		if(b != brickHead){
+			unlinkBrick(b);
+			pushFrontBrick(b);
+		}
+	}
+
+	sBrick& brick = bricks[b];
+	int cell = (((z & F3D_BRICK_MASK) << F3D_BRICK_SHIFT | (y & F3D_BRICK_MASK)) << F3D_BRICK_SHIFT) | (x & F3D_BRICK_MASK);
+	uint64_t bit = (uint64_t)1 << (cell & 63);
+	if(!(brick.valid[cell >> 6] & bit)){
+		calcPoint.x = x;
+		calcPoint.y = y;
+		calcPoint.z = (float)z * 0.03125f;//  /32.0f;
+		brick.index[cell] = indexedTexture->getColorIndex(calcPoint);
+		brick.valid[cell >> 6] |= bit;
+	}
+	return brick.index[cell];
+}
 #endif
 
 const char* s_f3d::getNameFuction(int num)
@@ -126,6 +198,38 @@ int s_f3d::calcTree(int x, int y, int z)
 void s_f3d::recalcWorld(void)
 {
 	int i,j;
+#ifdef _TX3D_LIBRARY_
+	//Весь мир - строками, кэш кирпичей тут только бы вытеснялся
+	clearBrickCache();
+	rowPoints.resize(vMap.H_SIZE);
+	rowIndexes.resize(vMap.H_SIZE);
+	for(i=0; i<vMap.V_SIZE; i++){
+		int cnt=0;
+		for(j=0; j<vMap.H_SIZE; j++){
+			int of=vMap.offsetBuf(j,i);
+			if(vMap.VxDBuf[of]==0) {
+				short v=(vMap.VxGBuf[of]<<VX_FRACTION)|(vMap.AtrBuf[of]&VX_FRACTION_MASK);
+#ifdef _PERIMETER_
+				if(v) 
+#endif
+					rowPoints[cnt++] = tx3d::Vector3D(j, i, (float)v * 0.03125f);
+			}
+		}
+		if(!cnt) continue;
+		indexedTexture->getColorIndexRow(&rowPoints[0], &rowIndexes[0], cnt);
+		cnt=0;
+		for(j=0; j<vMap.H_SIZE; j++){
+			int of=vMap.offsetBuf(j,i);
+			if(vMap.VxDBuf[of]==0) {
+				short v=(vMap.VxGBuf[of]<<VX_FRACTION)|(vMap.AtrBuf[of]&VX_FRACTION_MASK);
+#ifdef _PERIMETER_
+				if(v) 
+#endif
+					vMap.SurBuf[of]=rowIndexes[cnt++];
+			}
+		}
+	}
+#else
 	for(i=0; i<vMap.V_SIZE; i++){
 		for(j=0; j<vMap.H_SIZE; j++){
 			int of=vMap.offsetBuf(j,i);
@@ -138,6 +242,7 @@ void s_f3d::recalcWorld(void)
 			}
 		}
 	}
+#endif
 }
 
 #ifdef _SURMAP_
@@ -193,6 +298,7 @@ void s_f3d::loadVariable(void)
 		pTx = tx3d::Texture3DFactory::createTexture3D("<texture type='Clear'/>");
 	}
 	indexedTexture->setTexture(pTx);
+	clearBrickCache();
 
 	std::ifstream ifsLattice(GetTargetName("geoLattice.bin"), std::ios::in | std::ios::binary);
 	if (ifsLattice) {
@@ -3,6 +3,7 @@
 
 #ifdef _TX3D_LIBRARY_
 	#include <tx3d.hpp>
+	#include <unordered_map>
 #endif
 
 #define MAX_3D_FUNCTION 2
@@ -21,14 +22,40 @@ struct s_f3d {
 	tx3d::IndexedTexture3D *indexedTexture;
 	tx3d::Vector3D calcPoint;
 	~s_f3d(void);
+
+	//Кэш уже посчитанных индексов цвета кирпичами F3D_BRICK_SIZE^3 по (x,y,z),
+	//повторные пересчёты вокруг места копания/гео эффекта не трогают текстуру.
+	//Давно не использованные кирпичи вытесняются (LRU)
+	enum {
+		F3D_BRICK_SHIFT = 3,
+		F3D_BRICK_SIZE = 1 << F3D_BRICK_SHIFT,
+		F3D_BRICK_MASK = F3D_BRICK_SIZE - 1,
+		F3D_BRICK_CELLS = F3D_BRICK_SIZE * F3D_BRICK_SIZE * F3D_BRICK_SIZE,
+		F3D_BRICK_CACHE_SIZE = 1024
+	};
+	struct sBrick {
+		uint64_t key;
+		int prev, next;
+		uint64_t valid[F3D_BRICK_CELLS / 64];
+		unsigned char index[F3D_BRICK_CELLS];
+	};
+	std::vector<sBrick> bricks;
+	std::unordered_map<uint64_t, int> brickMap;
+	int brickHead, brickTail;
+
+	int calcCached(int x, int y, int z);
+	void clearBrickCache();
+	void unlinkBrick(int b);
+	void pushFrontBrick(int b);
+
+	//Рассчёт ряда точек за один проход по октавам текстуры, минуя кэш
+	std::vector<tx3d::Vector3D> rowPoints;
+	std::vector<unsigned char> rowIndexes;
 #endif
 
 	inline int calc(int x, int y, int z){
 #if defined(_TX3D_LIBRARY_)
-		calcPoint.x = x;
-		calcPoint.y = y;
-		calcPoint.z = (float)z * 0.03125f;//  /32.0f;
-		return indexedTexture->getColorIndex(calcPoint);
+		return calcCached(x, y, z);
 #elif defined(_GEOTOOL_)
 		return 0;
 #else
@@ -91,6 +91,7 @@ void vrtMap::initGrid(void)
 
 		}
 	}
+	changedGridAll();
 
 /*	//Сетка проходимости
 	//очистка сетки проходимости
@@ -198,6 +199,7 @@ void vrtMap::recalcArea2Grid(int xl, int yt, int xr, int yb )
 			GABuf[ofG]=atg;
 		}
 	}
+	changedGrid(xlG, ytG, xlG+dxG-1, ytG+dyG-1);
 
 /*
 //	Пересчет сетки проходимости
@@ -259,5 +261,6 @@ void vrtMap::loadGrid(XBuffer & ff)
 		//	GABuf[offsetGBuf(j,i)] &= ~(GRIDAT_BUILDING|GRIDAT_BASE_OF_BUILDING_CORRUPT);
 		//}
 	}
+	changedGridAll();
 }
 
@@ -127,6 +127,7 @@ inline void damagingBuildingsTolzer(int _x, int _y, int _r)
 			}
 		}
 	}
+	vMap.changedGrid(x - r, y - r, x + r, y + r);
 }
 
 inline void damagingBuildingsTolzerS(int _xL, int _yU, int _xR, int _yD)
@@ -144,6 +145,7 @@ inline void damagingBuildingsTolzerS(int _xL, int _yU, int _xR, int _yD)
 			}
 		}
 	}
+	vMap.changedGrid(xL, yU, xR, yD);
 }
 
 inline void damagingBuildingsTolzerS(int _x, int _y, int _r)
@@ -742,6 +744,7 @@ inline void clearAtrBaseOfBuildingCorrupt(int x, int y, int rad)
 			vMap.GABuf[curoff]&=~GRIDAT_BASE_OF_BUILDING_CORRUPT;
 		}
 	}
+	vMap.changedGrid(begxg, begyg, endxg, endyg);
 }
 
 //individualToolzer<T2TE_ALIGNMENT_TERRAIN_4ZP> toolzerAligmentTerrain4ZP;
@@ -1,13 +1,141 @@
 #include "stdafxTr.h"
 
 
-static const int MAX_SIZE_UNDO_REDO_BUFFER=4096*4096;
 int UNDO_REDO_BUFFER_SIZE=0;
+
+//PackBits: c<128 - c+1 байт как есть, иначе повтор следующего байта 257-c раз.
+//Повторы короче 3 идут внутри литерала, поэтому результат не больше undoPackedMaxSize(n).
+//Возвращает -1, если не влезло в capacity
+static int undoPack(const unsigned char* src, int n, unsigned char* dst, int capacity)
+{
+	int i=0, out=0;
+	while(i<n){
+		int run=1;
+		while(i+run<n && run<128 && src[i+run]==src[i]) run++;
+		if(run>=3){
+			if(out+2 > capacity) break;
+			dst[out++]=(unsigned char)(257-run);
+			dst[out++]=src[i];
+			i+=run;
+		}
+		else {
+			int lit=1;
+			while(i+lit<n && lit<128 && !(i+lit+2<n && src[i+lit]==src[i+lit+1] && src[i+lit]==src[i+lit+2])) lit++;
+			if(out+1+lit > capacity) break;
+			dst[out++]=(unsigned char)(lit-1);
+			memcpy(dst+out, src+i, lit);
+			out+=lit;
+			i+=lit;
+		}
+	}
+	xassert(i==n);
+	return i==n ? out : -1;
+}
+
+static void undoUnpack(const unsigned char* src, unsigned char* dst, int n)
+{
+	int out=0;
+	while(out<n){
+		int c=*src++;
+		if(c<128){
+			memcpy(dst+out, src, c+1);
+			src+=c+1;
+			out+=c+1;
+		}
+		else {
+			int run=257-c;
+			memset(dst+out, *src++, run);
+			out+=run;
+		}
+	}
+}
+
+//Заголовок на каждые 128 байт литерала
+static int undoPackedMaxSize(int n)
+{
+	return n + n/128 + 1;
+}
+
+void vrtMap::UndoDispatcher_Gather(const sPreChangedArea& area, unsigned char* dst)
+{
+	int size=area.sx*area.sy;
+	int i, j, cnt=0;
+	for(i=0; i<area.sy; i++){
+		for(j=0; j<area.sx; j++){
+			int off=offsetBuf(XCYCL(area.x+j), YCYCL(area.y+i));
+			dst[cnt]=VxGBuf[off];
+			dst[size+cnt]=VxDBuf[off];
+			dst[2*size+cnt]=AtrBuf[off];
+			dst[3*size+cnt]=SurBuf[off];
+			cnt++;
+		}
+	}
+}
+
+//Кладёт undoPacked в кольцевой буфер, вытесняя самые старые области
+bool vrtMap::UndoDispatcher_Store(sPreChangedArea& area, int packedSize)
+{
+	int offset;
+	for(;;){
+		if(preCAs.empty()) offset=undoArena.place(0, 0, packedSize);
+		else offset=undoArena.place(&preCAs.front(), &preCAs.back(), packedSize);
+		if(offset >= 0 || preCAs.empty()) break;
+		UNDO_REDO_BUFFER_SIZE-=preCAs.front().size;
+		preCAs.pop_front();
+	}
+	if(offset < 0) return false;
+	if(undoArena.buf.empty()) undoArena.buf.resize(undoArena.capacity);
+	memcpy(&undoArena.buf[offset], &undoPacked[0], packedSize);
+	area.offset=offset;
+	area.size=packedSize;
+	UNDO_REDO_BUFFER_SIZE+=packedSize;
+	return true;
+}
+
+//Последнее изменение закончено - исходное состояние заменяется на XOR с текущим
+void vrtMap::UndoDispatcher_FinishLast(void)
+{
+	if(preCAs.empty() || preCAs.back().delta) return;
+	sPreChangedArea area=preCAs.back();
+	int size=area.sx*area.sy*4;
+	undoRaw.resize(size);
+	undoCur.resize(size);
+	undoPacked.resize(undoPackedMaxSize(size));
+	undoUnpack(&undoArena.buf[area.offset], &undoRaw[0], size);
+	UndoDispatcher_Gather(area, &undoCur[0]);
+	int i;
+	for(i=0; i<size; i++) undoRaw[i]^=undoCur[i];
+	int packedSize=undoPack(&undoRaw[0], size, &undoPacked[0], undoPacked.size());
+
+	UNDO_REDO_BUFFER_SIZE-=area.size;
+	preCAs.pop_back();
+	area.delta=true;
+	if(packedSize >= 0 && UndoDispatcher_Store(area, packedSize)) preCAs.push_back(area);
+	curPreCA=preCAs.end();
+}
+
+void vrtMap::UndoDispatcher_Apply(sPreChangedArea& area)
+{
+	int size=area.sx*area.sy;
+	undoRaw.resize(size*4);
+	undoUnpack(&undoArena.buf[area.offset], &undoRaw[0], size*4);
+	int i, j, cnt=0;
+	for(i=0; i<area.sy; i++){
+		for(j=0; j<area.sx; j++){
+			int off=offsetBuf(XCYCL(area.x+j), YCYCL(area.y+i));
+			VxGBuf[off]^=undoRaw[cnt];
+			VxDBuf[off]^=undoRaw[size+cnt];
+			AtrBuf[off]^=undoRaw[2*size+cnt];
+			SurBuf[off]^=undoRaw[3*size+cnt];
+			cnt++;
+		}
+	}
+	regRender(area.x, area.y, XCYCL(area.x+area.sx), YCYCL(area.y+area.sy) );
+}
+
 void vrtMap::UndoDispatcher_PutPreChangedArea(int xL, int yT, int xR, int yB)
 {
 #ifdef _SURMAP_
-	//preCAs.erase(preCAs.begin(), preCAs.end());
-	//curPreCA=preCAs.begin();
 	xL=XCYCL(xL);
 	xR=XCYCL(xR);
 	yT=YCYCL(yT);
@@ -19,34 +147,25 @@ void vrtMap::UndoDispatcher_PutPreChangedArea(int xL, int yT, int xR, int yB)
 	else sy=XCYCL(yB-yT);
 	if(sx > H_SIZE) sx=H_SIZE;
 	if(sy > V_SIZE) sy=V_SIZE;
-	int size=sx*sy;
-
-	//list<sPreChangedArea>::iterator pp;
-	if(curPreCA!=preCAs.end()) preCAs.erase(curPreCA, preCAs.end()); //Удаление не нужных элементов
-	//Проверка на переполнение буфера и удаление 1-х элементов
-	while((UNDO_REDO_BUFFER_SIZE+size) > MAX_SIZE_UNDO_REDO_BUFFER){
-		if(preCAs.begin()==preCAs.end())ErrH.Abort("Список пустой а UNDO_REDO_BUFFER_SIZE==", XERR_USER, UNDO_REDO_BUFFER_SIZE);
-		preCAs.erase(preCAs.begin());
-	}
-	preCAs.push_back();
-	curPreCA=preCAs.end();
-	curPreCA--;//Теперь указывет на последний элемент
-	curPreCA->setSize(sx, sy);
-	int i, j, cnt=0;
-	for(i=0; i<sy; i++){
-		for(j=0; j<sx; j++){
-			//unsigned char g,d,a,s;
-			int off=offsetBuf(XCYCL(xL+j), YCYCL(yT+i));
-			(curPreCA->geo)[cnt]=VxGBuf[off];
-			(curPreCA->dam)[cnt]=VxDBuf[off];
-			(curPreCA->atr)[cnt]=AtrBuf[off];
-			(curPreCA->sur)[cnt]=SurBuf[off];
-			cnt++;
-		}
-	}
-	curPreCA->x=xL;
-	curPreCA->y=yT;
-	curPreCA++;// теперь указывает на окончание
+	int size=sx*sy*4;
+
+	//Удаление не нужных элементов
+	std::list<sPreChangedArea>::iterator pp;
+	for(pp=curPreCA; pp!=preCAs.end(); ++pp) UNDO_REDO_BUFFER_SIZE-=pp->size;
+	preCAs.erase(curPreCA, preCAs.end());
+	UndoDispatcher_FinishLast();
+
+	sPreChangedArea area;
+	area.x=xL;
+	area.y=yT;
+	area.sx=sx;
+	area.sy=sy;
+	undoRaw.resize(size);
+	undoPacked.resize(undoPackedMaxSize(size));
+	UndoDispatcher_Gather(area, &undoRaw[0]);
+	int packedSize=undoPack(&undoRaw[0], size, &undoPacked[0], undoPacked.size());
+	if(packedSize >= 0 && UndoDispatcher_Store(area, packedSize)) preCAs.push_back(area);
+	curPreCA=preCAs.end();// теперь указывает на окончание
 #endif
 }
 
@@ -55,25 +174,12 @@ void vrtMap::UndoDispatcher_Undo(void)
 	if( preCAs.begin() ==preCAs.end()) return; //если пустой список то возврат
 	if(curPreCA==preCAs.begin()) return;//если уже нет изменений
 
-	curPreCA--;//Теперь указывет на последний элемент
-	int xL=curPreCA->x;
-	int yT=curPreCA->y;
-	int sx=curPreCA->sx;
-	int sy=curPreCA->sy;
-	int i, j, cnt=0;
-	for(i=0; i<sy; i++){
-		for(j=0; j<sx; j++){
-			unsigned char t;
-			int off=offsetBuf(XCYCL(xL+j), YCYCL(yT+i));
-			t=VxGBuf[off]; VxGBuf[off]=(curPreCA->geo)[cnt]; (curPreCA->geo)[cnt]=t;
-			t=VxDBuf[off]; VxDBuf[off]=(curPreCA->dam)[cnt]; (curPreCA->dam)[cnt]=t;
-			t=AtrBuf[off]; AtrBuf[off]=(curPreCA->atr)[cnt]; (curPreCA->atr)[cnt]=t;
-			t=SurBuf[off]; SurBuf[off]=(curPreCA->sur)[cnt]; (curPreCA->sur)[cnt]=t;
-			cnt++;
-		}
+	if(curPreCA==preCAs.end()){
+		UndoDispatcher_FinishLast();
+		if(curPreCA==preCAs.begin()) return;
 	}
-	//curPreCA++;// теперь указывает на окончание
-	regRender(xL, yT, XCYCL(xL+sx), YCYCL(yT+sy) );
+	curPreCA--;//Теперь указывет на последний элемент
+	UndoDispatcher_Apply(*curPreCA);
 }
 
 void vrtMap::UndoDispatcher_Redo(void)
@@ -81,23 +187,7 @@ void vrtMap::UndoDispatcher_Redo(void)
 	if( preCAs.begin() ==preCAs.end()) return; //если пустой список то возврат
 	if(curPreCA==preCAs.end()) return;//если уже нет изменений
 
-	int xL=curPreCA->x;
-	int yT=curPreCA->y;
-	int sx=curPreCA->sx;
-	int sy=curPreCA->sy;
-	int i, j, cnt=0;
-	for(i=0; i<sy; i++){
-		for(j=0; j<sx; j++){
-			unsigned char t;
-			int off=offsetBuf(XCYCL(xL+j), YCYCL(yT+i));
-			t=VxGBuf[off]; VxGBuf[off]=(curPreCA->geo)[cnt]; (curPreCA->geo)[cnt]=t;
-			t=VxDBuf[off]; VxDBuf[off]=(curPreCA->dam)[cnt]; (curPreCA->dam)[cnt]=t;
-			t=AtrBuf[off]; AtrBuf[off]=(curPreCA->atr)[cnt]; (curPreCA->atr)[cnt]=t;
-			t=SurBuf[off]; SurBuf[off]=(curPreCA->sur)[cnt]; (curPreCA->sur)[cnt]=t;
-			cnt++;
-		}
-	}
-	regRender(xL, yT, XCYCL(xL+sx), YCYCL(yT+sy) );
+	UndoDispatcher_Apply(*curPreCA);
 	curPreCA++;
 }
 
@@ -105,6 +195,7 @@ void vrtMap::UndoDispatcher_KillAllUndo(void)
 {
 	preCAs.erase(preCAs.begin(), preCAs.end());
 	curPreCA=preCAs.begin();
+	UNDO_REDO_BUFFER_SIZE=0;
 }
 
 bool vrtMap::UndoDispatcher_IsUndoExist(void)
@@ -1,36 +1,44 @@
 
-extern int UNDO_REDO_BUFFER_SIZE; //Текущий размер буфера в SurMap пикселах
+static const int MAX_SIZE_UNDO_REDO_BUFFER=4096*4096*2; //Бюджет памяти сжатых данных Undo-Redo
+extern int UNDO_REDO_BUFFER_SIZE; //Текущий размер сжатых данных Undo-Redo в байтах
 
+//Область изменения для Undo-Redo.
+//Пока изменение не закончено хранит исходное состояние, после - XOR исходного
+//состояния с изменённым, тогда и Undo и Redo - один и тот же XOR с картой.
+//Слои geo, dam, atr, sur идут подряд и сжаты PackBits в кольцевом буфере sUndoArena
 struct sPreChangedArea {
 	short x, y;
 	short sx, sy;
-	unsigned char* geo;
-	unsigned char* dam;
-	unsigned char* atr;
-	unsigned char* sur;
+	int offset; //Смещение сжатых данных в sUndoArena
+	int size; //Размер сжатых данных
+	bool delta;
 	sPreChangedArea(void){
-		geo=NULL;
-		dam=NULL;
-		atr=NULL;
-		sur=NULL;
+		x=y=sx=sy=0;
+		offset=size=0;
+		delta=false;
 	};
-	void setSize(int _sx, int _sy){
-		sx=_sx; sy=_sy;
-		int size=sx*sy;
-		UNDO_REDO_BUFFER_SIZE+=size;
-		geo=new unsigned char[size];
-		dam=new unsigned char[size];
-		atr=new unsigned char[size];
-		sur=new unsigned char[size];
+};
+
+//Кольцевой буфер сжатых областей. Порядок данных в буфере совпадает с порядком
+//областей в списке, поэтому начало и конец занятой части берутся из первой и последней областей
+struct sUndoArena {
+	std::vector<unsigned char> buf;
+	int capacity;
+	sUndoArena(void){
+		capacity=MAX_SIZE_UNDO_REDO_BUFFER;
 	};
-	~sPreChangedArea(void){
-		if(sur){
-			int size=sx*sy;
-			UNDO_REDO_BUFFER_SIZE-=size;
-			if(sur) delete [] sur;
-			if(atr) delete [] atr;
-			if(dam) delete [] dam;
-			if(geo) delete [] geo;
+	//Смещение для size байт после last или -1, если место занято областью first
+	int place(const sPreChangedArea* first, const sPreChangedArea* last, int size){
+		if(size > capacity) return -1;
+		if(!first) return 0;
+		int head=first->offset;
+		int tail=last->offset+last->size;
+		if(last->offset >= head){
+			if(capacity-tail >= size) return tail;
+			if(head >= size) return 0;
+			return -1;
 		}
+		if(head-tail >= size) return tail;
+		return -1;
 	};
-};
\ No newline at end of file
+};
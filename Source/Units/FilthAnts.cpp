@@ -85,27 +85,11 @@ terFilthSwarmAnt::~terFilthSwarmAnt()
 		(*i_unit)->Kill();
 }
 
-float terFilthSwarmAnt::GetFollow(Vect3f& v1,Vect3f& v2,float a,Vect3f& result)
-{
-	Vect3f v;
-	float d;
-	v = v2;
-	v -= v1;
-	d = v.norm();
-	if(d > FLT_EPS)
-		v *= prm->follow_distance / d;
-	else
-		v = Vect3f(1.0f,0,0);
-	v += v1;
-	result = v;
-	return d;
-}
-
 void terFilthSwarmAnt::Quant()
 {
 	Vect3f v1,v2,v;
 	Vect3f nv;
-	float adist,dist,a,d;
+	float adist,dist,d;
 	FilthListType::iterator i_unit;
 
 	terFilthSwarm::Quant();
@@ -143,8 +127,7 @@ void terFilthSwarmAnt::Quant()
 			show_vector(v,2,RED);
 		}
 
-		i_unit = unitList.begin();
-		a = (*i_unit)->angleZ();
+		i_unit = unitList.begin();
 		v1 = (*i_unit)->position();
 
 		sound.SetPos(To3D(v1));
@@ -177,21 +160,20 @@ void terFilthSwarmAnt::Quant()
 
 		adist = 0;
 
+		swarm_positions.gather(unitList);
+		swarm_positions.followChain(prm->follow_distance);
+
 		i_unit++;
 		int UnitNum=0;
-		while(i_unit != unitList.end()){
-			v2 = (*i_unit)->position();
-			dist = GetFollow(v1,v2,a,v);
+		for(int i = 1; i_unit != unitList.end(); i++, i_unit++){
+			dist = swarm_positions.dist[i];
 			adist += dist;
 			UnitNum++;
 			if(dist > prm->follow_distance)
 				(*i_unit)->SetFilthScale(2.0f);
 			else
 				(*i_unit)->SetFilthScale(1.0f);
-			(*i_unit)->SetFilthTarget(v);
-			a = (*i_unit)->angleZ();
-			v1 = v2;
-			i_unit++;
+			(*i_unit)->SetFilthTarget(swarm_positions.target[i]);
 		}
 		if(UnitNum > 1){
 			adist /= (float)(UnitNum - 1);
@@ -50,7 +50,6 @@ public:
 	void AddFilthPoint(terFilthAnt* p);
 	void GenerationProcess();
 
-	float GetFollow(Vect3f& v1,Vect3f& v2,float a,Vect3f& result);
 	void SetCreatureGeneration(int creature_num,int generation_period);
 	terUnitAttributeID GetUnitID();
 	void SetFreeDestroy();
@@ -71,29 +71,19 @@ void terFilthSwarmCrow::Quant()
 		int crow_attack=terFilthCrowPrm.at_one_time_atrack;
 		if(num_target==0 || (num_target<crow_attack && unit_list.size()>=crow_attack))
 		{
-			while(num_target<crow_attack)
-			{
-				terFilthCrow* find=NULL;
-				float dist2=0;
-
-				FilthListType::iterator it;
-				FOR_EACH(unit_list,it)
-				{
-					if((*it)->GetTarget())
-						continue;
-					float d=attack_pos.distance2((*it)->position());
-					if(!find || d<dist2)
-					{
-						dist2=d;
-						find=*it;
-					}
-				}
-
-				if(!find)
-					break;
-				find->SetTarget(TargetPoint);
-				num_target++;
-			}
+			//Сразу выбираем всех недостающих атакующих, ближайших к цели
+			std::vector<terFilthCrow*> crows(unit_list.begin(),unit_list.end());
+			std::vector<char> free_crow(crows.size());
+			for(int i=0;i<crows.size();i++)
+				free_crow[i]=!crows[i]->GetTarget();
+
+			std::vector<int> attackers;
+			swarm_positions.gather(unit_list);
+			swarm_positions.nearest(attack_pos,free_crow,crow_attack-num_target,attackers);
+
+			std::vector<int>::iterator ia;
+			FOR_EACH(attackers,ia)
+				crows[*ia]->SetTarget(TargetPoint);
 		}
 	}
 
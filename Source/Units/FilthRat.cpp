@@ -76,27 +76,11 @@ void terFilthSwarmRat::SetFreeDestroy()
 		(*i_unit)->SetFreeDestroy();
 }
 
-float terFilthSwarmRat::GetFollow(Vect3f& v1,Vect3f& v2,float a,Vect3f& result)
-{
-	Vect3f v;
-	float d;
-	v = v2;
-	v -= v1;
-	d = v.norm();
-	if(d > FLT_EPS)
-		v *= terFilthRatPrm.follow_distance / d;
-	else
-		v = Vect3f(1.0f,0,0);
-	v += v1;
-	result = v;
-	return d;
-}
-
 void terFilthSwarmRat::Quant()
 {
 	Vect3f v1,v2,v;
 	Vect3f nv;
-	float adist,dist,a,d;
+	float adist,dist,d;
 	FilthListType::iterator i_unit;
 
 	terFilthSwarm::Quant();
@@ -152,8 +136,7 @@ void terFilthSwarmRat::Quant()
 			
 			v2=v;
 
-			i_unit = unitList.begin();
-			a = (*i_unit)->angleZ();
+			i_unit = unitList.begin();
 			v1 = (*i_unit)->position();
 			sound.SetPos(To3D(v1));
 
@@ -187,20 +170,19 @@ void terFilthSwarmRat::Quant()
 
 			adist = 0;
 
+			swarm_positions.gather(unitList);
+			swarm_positions.followChain(terFilthRatPrm.follow_distance);
+
 			i_unit++;
-			while(i_unit != unitList.end())
+			for(int i = 1; i_unit != unitList.end(); i++, i_unit++)
 			{
-				v2 = (*i_unit)->position();
-				dist = GetFollow(v1,v2,a,v);
+				dist = swarm_positions.dist[i];
 				adist += dist;
 				if(dist > terFilthRatPrm.follow_distance)
 					(*i_unit)->SetFilthScale(2.0f);
 				else
 					(*i_unit)->SetFilthScale(1.0f);
-				(*i_unit)->SetFilthTarget(v);
-				a = (*i_unit)->angleZ();
-				v1 = v2;
-				i_unit++;
+				(*i_unit)->SetFilthTarget(swarm_positions.target[i]);
 			}
 
 			if(unitList.size() > 1)
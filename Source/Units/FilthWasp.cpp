@@ -96,18 +96,18 @@ void terFilthSwarmWasp::Quant()
 	if(!TargetPoint)
 		FindTargetPoint();
 
+	//Цель одна на всю стаю
+	Vect3f target_pos=position+Vect3f(0,1,0);
+	float target_radius=1;
+	if(TargetPoint)
+	{
+		target_pos=TargetPoint->position();
+		target_radius=TargetPoint->radius();
+	}
+
 	FOR_EACH(unit_list,it)
 	{
-		if(TargetPoint)
-		{
-			RigidBody* rb=TargetPoint->GetRigidBodyPoint();
-			Vect3f ps=rb->matrix()*rb->boxMax();
-			Vect3f pos=TargetPoint->position();
-			pos.z=ps.z;
-			(*it)->SetFilthTarget(TargetPoint->position(),TargetPoint->radius());
-		}
-		else
-			(*it)->SetFilthTarget(position+Vect3f(0,1,0),1);
+		(*it)->SetFilthTarget(target_pos,target_radius);
 		(*it)->SetFilthPos(position);
 	}
 
@@ -4,6 +4,7 @@
 #include "UnitAttribute.h"
 #include "Grid2D.h"
 #include "CommonCommands.h"
+#include "UnitPool.h"
 
 #if !defined(_MSC_VER) || (_MSC_VER >= 1900)
 #include <functional> // mem_fn, not_fn
@@ -34,6 +35,10 @@ public:
 	terUnitBase(const UnitTemplate& data);
 	virtual ~terUnitBase();
 
+	//Memory comes from UnitPool slabs, slot is recycled when HTManager finally deletes unit
+	static void* operator new(size_t size) { return UnitPool::alloc(size); }
+	static void operator delete(void* ptr) { UnitPool::free(ptr); }
+
 	virtual void MoveQuant() {}
 	virtual void Quant() {}
 	virtual void Kill();
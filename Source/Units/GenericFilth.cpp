@@ -939,6 +939,44 @@ void terFilthGeneric::FieldEffect()
 	effect->SetPosition(pose());
 }
 
+///////////////////////////terFilthSwarmPositions//////////////////////////
+void terFilthSwarmPositions::followChain(float follow_distance)
+{
+	int n = size();
+	dist.resize(n);
+	target.resize(n);
+	for(int i = 1; i < n; i++){
+		Vect3f v1(x[i - 1], y[i - 1], z[i - 1]);
+		Vect3f v(x[i], y[i], z[i]);
+		v -= v1;
+		float d = v.norm();
+		if(d > FLT_EPS)
+			v *= follow_distance / d;
+		else
+			v = Vect3f(1.0f,0,0);
+		v += v1;
+		dist[i] = d;
+		target[i] = v;
+	}
+}
+
+void terFilthSwarmPositions::nearest(const Vect3f& point, const std::vector<char>& allowed, int count, std::vector<int>& result)
+{
+	order.clear();
+	int n = size();
+	for(int i = 0; i < n; i++)
+		if(allowed[i])
+			order.push_back(std::make_pair(point.distance2(get(i)), i));
+
+	//При равном расстоянии раньше идёт тот, кто раньше в списке
+	count = std::max(0, std::min(count, (int)order.size()));
+	std::partial_sort(order.begin(), order.begin() + count, order.end());
+
+	result.clear();
+	for(int i = 0; i < count; i++)
+		result.push_back(order[i].second);
+}
+
 ///////////////////////////terFilthSwarm//////////////////////////
 terFilthSwarm::terFilthSwarm(terFilthSpot* spot, const Vect3f& pos)
 { 
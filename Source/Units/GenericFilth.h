@@ -82,6 +82,41 @@ protected:
 	virtual void addWayPoint()=0;
 };
 
+//Позиции существ стаи в отдельных массивах, чтобы считать
+//следование по цепочке и выбор ближайших одним проходом
+struct terFilthSwarmPositions
+{
+	std::vector<float> x, y, z;
+	//Результат followChain, для первого существа не заполняется
+	std::vector<float> dist;
+	std::vector<Vect3f> target;
+
+	int size() const { return x.size(); }
+	Vect3f get(int i) const { return Vect3f(x[i], y[i], z[i]); }
+
+	template<class List>
+	void gather(const List& list) {
+		x.resize(list.size());
+		y.resize(list.size());
+		z.resize(list.size());
+		int i = 0;
+		for (typename List::const_iterator it = list.begin(); it != list.end(); ++it, ++i) {
+			const Vect3f& p = (*it)->position();
+			x[i] = p.x;
+			y[i] = p.y;
+			z[i] = p.z;
+		}
+	}
+
+	//Каждое существо идёт за предыдущим на расстоянии follow_distance
+	void followChain(float follow_distance);
+	//Индексы count ближайших к point среди разрешённых, по возрастанию расстояния
+	void nearest(const Vect3f& point, const std::vector<char>& allowed, int count, std::vector<int>& result);
+
+private:
+	std::vector<std::pair<float, int> > order;
+};
+
 struct terFilthSpot;
 
 struct terFilthSwarm
@@ -135,6 +170,8 @@ protected:
 	float attack_width;
 	float attack_direction;
 	terFilthAttackType attack_player;
+
+	terFilthSwarmPositions swarm_positions;
 };
 
 struct terFilthSpotParameters;
@@ -68,9 +68,9 @@ void terInterpolationReal::updateLogicObject()
 {
 	if(logicObject_){
 		if(currentChain())
-			logicObject_->SetChannel(currentChain()->chainName, node.phase_.x1());
-		logicObject_->SetPosition(Owner->pose());
-		logicObject_->Update();
+			logicObject_->SetChannelPosition(currentChain()->chainName, node.phase_.x1(), Owner->pose());
+		else
+			logicObject_->SetPosition(Owner->pose());
 	}
 }
 
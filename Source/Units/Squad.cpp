@@ -1426,6 +1426,120 @@ void terUnitSquad::recalcWayPoints()
 	}
 }
 
+//-----------------------------------------
+//	Назначение мест в строю
+//
+// Для каждого места ищется ближайший ещё не назначенный юнит (при равных
+// расстояниях - первый в списке), как при полном переборе, но поиск идёт
+// по сетке локальных позиций кольцами от ячейки места.
+class SquadFormationAssigner
+{
+public:
+	SquadFormationAssigner(const std::list<terUnitLegionary*>& unitList, float formationRadius)
+	{
+		units_.assign(unitList.begin(), unitList.end());
+		int count = units_.size();
+		positions_.resize(count);
+		removed_.assign(count, 0);
+		front_ = 0;
+
+		Vect2f posMin(FLT_INF, FLT_INF), posMax(-FLT_INF, -FLT_INF);
+		for(int i = 0; i < count; i++){
+			positions_[i] = units_[i]->localPosition();
+			posMin.x = min(posMin.x, positions_[i].x);
+			posMin.y = min(posMin.y, positions_[i].y);
+			posMax.x = max(posMax.x, positions_[i].x);
+			posMax.y = max(posMax.y, positions_[i].y);
+		}
+		if(!count)
+			posMin = posMax = Vect2f::ZERO;
+
+		origin_ = posMin;
+		cellSize_ = max(formationRadius*2, 1.f);
+		cellSize_ = max(cellSize_, max(posMax.x - posMin.x, posMax.y - posMin.y)/SQUAD_ASSIGN_GRID_MAX);
+		sizeX_ = min(int((posMax.x - posMin.x)/cellSize_) + 1, SQUAD_ASSIGN_GRID_MAX);
+		sizeY_ = min(int((posMax.y - posMin.y)/cellSize_) + 1, SQUAD_ASSIGN_GRID_MAX);
+
+		//Юниты в ячейке идут в порядке списка
+		cellStart_.assign(sizeX_*sizeY_ + 1, 0);
+		std::vector<int> cells(count);
+		for(int i = 0; i < count; i++){
+			cells[i] = cellY(positions_[i].y)*sizeX_ + cellX(positions_[i].x);
+			cellStart_[cells[i] + 1]++;
+		}
+		for(int c = 0; c < sizeX_*sizeY_; c++)
+			cellStart_[c + 1] += cellStart_[c];
+		cellUnits_.resize(count);
+		std::vector<int> fill(cellStart_.begin(), cellStart_.end() - 1);
+		for(int i = 0; i < count; i++)
+			cellUnits_[fill[cells[i]]++] = i;
+	}
+
+	terUnitLegionary* unit(int index) const { return units_[index]; }
+
+	//Первый не назначенный юнит по списку, -1 если таких нет
+	int front()
+	{
+		while(front_ < (int)units_.size() && removed_[front_])
+			front_++;
+		return front_ < (int)units_.size() ? front_ : -1;
+	}
+
+	void remove(int index) { removed_[index] = 1; }
+
+	int nearest(const Vect2f& pos) const
+	{
+		int cx = cellX(pos.x);
+		int cy = cellY(pos.y);
+		int best = -1;
+		float dist2, min_dist2 = FLT_INF;
+		int rmax = max(sizeX_, sizeY_);
+		for(int r = 0; r <= rmax; r++){
+			for(int y = cy - r; y <= cy + r; y++){
+				if(y < 0 || y >= sizeY_)
+					continue;
+				int step = (y == cy - r || y == cy + r) ? 1 : 2*r;
+				for(int x = cx - r; x <= cx + r; x += step){
+					if(x < 0 || x >= sizeX_)
+						continue;
+					int c = y*sizeX_ + x;
+					for(int k = cellStart_[c]; k < cellStart_[c + 1]; k++){
+						int i = cellUnits_[k];
+						if(removed_[i])
+							continue;
+						dist2 = positions_[i].distance2(pos);
+						if(min_dist2 > dist2 || (min_dist2 == dist2 && i < best)){
+							min_dist2 = dist2;
+							best = i;
+						}
+					}
+				}
+			}
+			//В кольцах дальше r юниты не ближе (r - 1)*cellSize_, с запасом на округление
+			if(best >= 0 && r > 0 && min_dist2 < sqr((r - 1)*cellSize_))
+				break;
+		}
+		return best;
+	}
+
+private:
+	enum { SQUAD_ASSIGN_GRID_MAX = 64 };
+
+	std::vector<terUnitLegionary*> units_;
+	std::vector<Vect2f> positions_;
+	std::vector<char> removed_;
+	int front_;
+
+	Vect2f origin_;
+	float cellSize_;
+	int sizeX_, sizeY_;
+	std::vector<int> cellStart_;
+	std::vector<int> cellUnits_;
+
+	int cellX(float x) const { return clamp(int((x - origin_.x)/cellSize_), 0, sizeX_ - 1); }
+	int cellY(float y) const { return clamp(int((y - origin_.y)/cellSize_), 0, sizeY_ - 1); }
+};
+
 void terUnitSquad::repositionFormation(bool forceReposition)
 {
 	if(Empty()){
@@ -1458,24 +1572,20 @@ void terUnitSquad::repositionFormation(bool forceReposition)
 		}
 
 		position_generator.clear();
-		SquadUnitList units = Units;
-		while(!units.empty()){
-			if(units.front()->inSquad()){
+		SquadFormationAssigner assigner(Units, formationRadius());
+		int front;
+		while((front = assigner.front()) >= 0){
+			if(assigner.unit(front)->inSquad()){
 				Vect2f pos = position_generator.get(formationRadius());
-				float dist2, min_dist2 = FLT_INF;
-				SquadUnitList::iterator ui_best = units.begin();
-				SquadUnitList::iterator ui;
-				FOR_EACH(units, ui){
-					if(min_dist2 > (dist2 = (*ui)->localPosition().distance2(pos))){
-						min_dist2 = dist2;
-						ui_best = ui;
-					}
-				}
-				(*ui_best)->setLocalPosition(pos);
-				units.erase(ui_best);
+				int best = assigner.nearest(pos);
+				//Все расстояния NaN или бесконечны - как раньше, берём первого
+				if(best < 0)
+					best = front;
+				assigner.unit(best)->setLocalPosition(pos);
+				assigner.remove(best);
 			}
 			else
-				units.erase(units.begin());
+				assigner.remove(front);
 		}
 	}
 
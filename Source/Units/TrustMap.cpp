@@ -40,6 +40,8 @@ terTerraformGeneral::terTerraformGeneral(int id,int x,int y,terPlayer* player)
 	UnitPoint = NULL;
 	Status = TERRAFORM_STATUS_NONE;
 	CollisionCount = 0;
+	IndexStatus = 0;
+	IndexOrder = 0;
 }
 
 terTerraformGeneral::~terTerraformGeneral()
@@ -94,6 +96,7 @@ void terTerraformGeneral::Quant(terTerraformDispatcher* dispatcher,bool first)
 		{
 			dispatcher->TerraformsDigFill.push_front(this);
 			it_self=dispatcher->TerraformsDigFill.begin();
+			IndexOrder=dispatcher->IndexOrder++;
 		}else
 		{
 			dispatcher->TerraformsOther.push_front(this);
@@ -104,6 +107,7 @@ void terTerraformGeneral::Quant(terTerraformDispatcher* dispatcher,bool first)
 		xassert(self==this);
 	}
 
+	dispatcher->UpdateIndex(this,Status & (TERRAFORM_STATUS_DIG|TERRAFORM_STATUS_FILL));
 	ChangeStatus(dispatcher,last_status,Status);
 }
 
@@ -183,153 +187,122 @@ terTerraformFull::terTerraformFull(int id,int x,int y, terPlayer* player)
 {
 	Type = TERRAFORM_TYPE_FULL; 
 	Height = vMap.hZeroPlast;
-}
 
-void terTerraformFull::Show()
-{
-	sColor4c c(0,0,0);
-/*
-	if(IsDigFill())
-		c=sColor4c(255,255,255);
-/*/
-	if(Status & TERRAFORM_STATUS_DIG)
-		c.r += 127;
-	if(Status & TERRAFORM_STATUS_FILL)
-		c.g += 127;
-/**/
-	ShowRect(c,Status&TERRAFORM_STATUS_RESOURCE,Status&TERRAFORM_STATUS_PREPARED);
+	DigMask = FillMask = ZeroMask = 0;
+	MaskX0 = MaskY0 = MaskSX = MaskSY = 0;
+	MaskRevision = 0;
+	MaskValid = false;
 }
 
-int terTerraformFull::GetDigPosition(int& cx,int& cy)
+void terTerraformFull::UpdateMasks()
 {
-	int y,x;
-
 	int x0 = vMap.w2mClampX(PositionX - TERRAFORM_ELEMENT_SIDE);
 	int y0 = vMap.w2mClampY(PositionY - TERRAFORM_ELEMENT_SIDE);
 	int x1 = vMap.w2mClampX(PositionX + TERRAFORM_ELEMENT_SIDE);
 	int y1 = vMap.w2mClampY(PositionY + TERRAFORM_ELEMENT_SIDE);
 
-	int lx = -1;
-	int ly = -1;
-	x=(x0+x1)/2;
-	y=(y0+y1)/2;
-	unsigned short p = vMap.GABuf[vMap.offsetGBuf(x, y)];
+	if(MaskValid && vMap.getGridRevision(x0, y0, x1, y1) <= MaskRevision)
+		return;
 
-	if(!GRIDTST_LEVELED(p) && GRIDTST_TALLER_HZEROPLAST(p) && IsNoHardness(p)){
-		lx = vMap.m2wHalf(x);
-		ly = vMap.m2wHalf(y);
-		if(lx != cx || ly != cy){
-			cx = lx;
-			cy = ly;
-			return 1;
-		}
-	}
+	MaskX0 = x0;
+	MaskY0 = y0;
+	MaskSX = x1 - x0 + 1;
+	MaskSY = y1 - y0 + 1;
+	xassert(MaskSX*MaskSY <= 64);
 
-	for(y = y0;y <= y1;y++){
-		for(x = x0;x <= x1;x++){
+	DigMask = FillMask = ZeroMask = 0;
+	uint64_t bit = 1;
+	for(int y = y0;y <= y1;y++){
+		for(int x = x0;x <= x1;x++){
 			unsigned short p = vMap.GABuf[vMap.offsetGBuf(x, y)];
-
-			if(!GRIDTST_LEVELED(p) && GRIDTST_TALLER_HZEROPLAST(p) && IsNoHardness(p)){
-				lx = vMap.m2wHalf(x);
-				ly = vMap.m2wHalf(y);
-				if(lx != cx || ly != cy){
-					cx = lx;
-					cy = ly;
-					return 1;
-				}
-			}
+			if(!GRIDTST_LEVELED(p) && GRIDTST_TALLER_HZEROPLAST(p) && IsNoHardness(p))
+				DigMask |= bit;
+			if((!GRIDTST_LEVELED(p) && !GRIDTST_TALLER_HZEROPLAST(p)) || (GRIDTST_LEVELED(p) && (p & GRIDAT_BASE_OF_BUILDING_CORRUPT)))
+				FillMask |= bit;
+			if(!GRIDTST_ZEROPLAST(p) && GRIDTST_LEVELED(p))
+				ZeroMask |= bit;
+			bit <<= 1;
 		}
 	}
 
-	if(lx != -1 && ly != -1){
-		cx = lx;
-		cy = ly;
-		return 1;
-	}
-	return 0;
+	MaskRevision = vMap.gridRevisionCounter;
+	MaskValid = true;
 }
 
-int terTerraformFull::GetFillPosition(int& cx,int& cy)
+int terTerraformFull::FindMaskPosition(uint64_t mask, bool center_first, int& cx, int& cy, RegionDispatcher* region)
 {
-	int y,x;
+	if(!mask)
+		return 0;
 
-	int x0 = vMap.w2mClampX(PositionX - TERRAFORM_ELEMENT_SIDE);
-	int y0 = vMap.w2mClampY(PositionY - TERRAFORM_ELEMENT_SIDE);
-	int x1 = vMap.w2mClampX(PositionX + TERRAFORM_ELEMENT_SIDE);
-	int y1 = vMap.w2mClampY(PositionY + TERRAFORM_ELEMENT_SIDE);
-	
-	int lx = -1;
-	int ly = -1;
-	x=(x0+x1)/2;
-	y=(y0+y1)/2;
-	unsigned short p = vMap.GABuf[vMap.offsetGBuf(x, y)];
+	int found = 0;
+	if(center_first){
+		int x = MaskX0 + (MaskSX - 1)/2;
+		int y = MaskY0 + (MaskSY - 1)/2;
+		int index = (y - MaskY0)*MaskSX + (x - MaskX0);
+		if(((mask >> index) & 1) && (!region || region->filledRasterized(Vect2i(vMap.XCYCL(vMap.m2wHalf(x)), vMap.YCYCL(vMap.m2wHalf(y)))))){
+			int lx = vMap.m2wHalf(x);
+			int ly = vMap.m2wHalf(y);
+			if(lx != cx || ly != cy){
+				cx = lx;
+				cy = ly;
+				return 1;
+			}
+			found = 1;
+		}
+	}
 
-	if((!GRIDTST_LEVELED(p) && !GRIDTST_TALLER_HZEROPLAST(p)) || (GRIDTST_LEVELED(p) && (p & GRIDAT_BASE_OF_BUILDING_CORRUPT))){
-		lx = vMap.m2wHalf(x);
-		ly = vMap.m2wHalf(y);
+	while(mask){
+		int index = BitSF64(mask);
+		mask &= mask - 1;
+		int x = MaskX0 + index % MaskSX;
+		int y = MaskY0 + index / MaskSX;
+		if(region && !region->filledRasterized(Vect2i(vMap.XCYCL(vMap.m2wHalf(x)), vMap.YCYCL(vMap.m2wHalf(y)))))
+			continue;
+		int lx = vMap.m2wHalf(x);
+		int ly = vMap.m2wHalf(y);
 		if(lx != cx || ly != cy){
 			cx = lx;
 			cy = ly;
 			return 1;
 		}
+		found = 1;
 	}
 
-	for(y = y0;y <= y1;y++){
-		for(x = x0;x <= x1;x++){
-			unsigned short p = vMap.GABuf[vMap.offsetGBuf(x, y)];
-
-			if((!GRIDTST_LEVELED(p) && !GRIDTST_TALLER_HZEROPLAST(p)) || (GRIDTST_LEVELED(p) && (p & GRIDAT_BASE_OF_BUILDING_CORRUPT))){
-				lx = vMap.m2wHalf(x);
-				ly = vMap.m2wHalf(y);
-				if(lx != cx || ly != cy){
-					cx = lx;
-					cy = ly;
-					return 1;
-				}
-			}
-		}
-	}
+	//Подходит только текущая ячейка
+	return found;
+}
 
-	if(lx != -1 && ly != -1){
-		cx = lx;
-		cy = ly;
-		return 1;
-	}
-	return 0;
+void terTerraformFull::Show()
+{
+	sColor4c c(0,0,0);
+/*
+	if(IsDigFill())
+		c=sColor4c(255,255,255);
+/*/
+	if(Status & TERRAFORM_STATUS_DIG)
+		c.r += 127;
+	if(Status & TERRAFORM_STATUS_FILL)
+		c.g += 127;
+/**/
+	ShowRect(c,Status&TERRAFORM_STATUS_RESOURCE,Status&TERRAFORM_STATUS_PREPARED);
 }
 
-int terTerraformFull::GetZeroPosition(int& cx,int& cy)
+int terTerraformFull::GetDigPosition(int& cx,int& cy)
 {
-	int y,x;
+	UpdateMasks();
+	return FindMaskPosition(DigMask, true, cx, cy);
+}
 
-	int x0 = vMap.w2mClampX(PositionX - TERRAFORM_ELEMENT_SIDE);
-	int y0 = vMap.w2mClampY(PositionY - TERRAFORM_ELEMENT_SIDE);
-	int x1 = vMap.w2mClampX(PositionX + TERRAFORM_ELEMENT_SIDE);
-	int y1 = vMap.w2mClampY(PositionY + TERRAFORM_ELEMENT_SIDE);
-	
-	int lx = -1;
-	int ly = -1;
-	for(y = y0;y <= y1;y++){
-		for(x = x0;x <= x1;x++){
-			unsigned short p = vMap.GABuf[vMap.offsetGBuf(x, y)];
-			if(!GRIDTST_ZEROPLAST(p) && GRIDTST_LEVELED(p)){
-				lx = vMap.m2wHalf(x);
-				ly = vMap.m2wHalf(y);
-				if(lx != cx || ly != cy){
-					cx = lx;
-					cy = ly;
-					return 1;
-				}
-			}
-		}
-	}
+int terTerraformFull::GetFillPosition(int& cx,int& cy)
+{
+	UpdateMasks();
+	return FindMaskPosition(FillMask, true, cx, cy);
+}
 
-	if(lx != -1 && ly != -1){
-		cx = lx;
-		cy = ly;
-		return 1;
-	}
-	return 0;
+int terTerraformFull::GetZeroPosition(int& cx,int& cy)
+{
+	UpdateMasks();
+	return FindMaskPosition(ZeroMask, false, cx, cy);
 }
 
 int terTerraformFull::GetClusterAttribute(int cx,int cy,int sx,int sy,int& prepared_zero,int& resource_zero,int& dig_layer,int& fill_layer,int& ground_zero,int& cell,int& zero_present)
@@ -413,151 +386,35 @@ terTerraformBorder::terTerraformBorder(int id,int x,int y, terPlayer* player)
 
 int terTerraformBorder::GetDigPosition(int& cx,int& cy)
 {
-	int x,y;
+	UpdateMasks();
+	if(!DigMask)
+		return 0;
 
-	int x0 = vMap.w2mClampX(PositionX - TERRAFORM_ELEMENT_SIDE);
-	int y0 = vMap.w2mClampY(PositionY - TERRAFORM_ELEMENT_SIDE);
-	int x1 = vMap.w2mClampX(PositionX + TERRAFORM_ELEMENT_SIDE);
-	int y1 = vMap.w2mClampY(PositionY + TERRAFORM_ELEMENT_SIDE);
-	
 	MetaRegionLock lock(Player->RegionPoint);
 	RegionDispatcher* region = Player->ZeroRegionPoint.data();
-
-	int lx = -1;
-	int ly = -1;
-
-	x=(x0+x1)/2;
-	y=(y0+y1)/2;
-	if(region->filledRasterized(Vect2i(vMap.XCYCL(vMap.m2wHalf(x)), vMap.YCYCL(vMap.m2wHalf(y))))){
-		unsigned short p = vMap.GABuf[vMap.offsetGBuf(x, y)];
-		if(!GRIDTST_LEVELED(p) && GRIDTST_TALLER_HZEROPLAST(p) && IsNoHardness(p)){
-			lx = vMap.m2wHalf(x);
-			ly = vMap.m2wHalf(y);
-			if(lx != cx || ly != cy){
-				cx = lx;
-				cy = ly;
-				return 1;
-			}
-		}
-	}
-
-	for(y = y0;y <= y1;y++){
-		for(x = x0;x <= x1;x++){
-			if(region->filledRasterized(Vect2i(vMap.XCYCL(vMap.m2wHalf(x)), vMap.YCYCL(vMap.m2wHalf(y))))){
-				unsigned short p = vMap.GABuf[vMap.offsetGBuf(x, y)];
-				if(!GRIDTST_LEVELED(p) && GRIDTST_TALLER_HZEROPLAST(p) && IsNoHardness(p)){
-					lx = vMap.m2wHalf(x);
-					ly = vMap.m2wHalf(y);
-					if(lx != cx || ly != cy){
-						cx = lx;
-						cy = ly;
-						return 1;
-					}
-				}
-			}
-		}
-	}
-
-	if(lx != -1 && ly != -1){
-		cx = lx;
-		cy = ly;
-		return 1;
-	}
-	return 0;
+	return FindMaskPosition(DigMask, true, cx, cy, region);
 }
 
 int terTerraformBorder::GetFillPosition(int& cx,int& cy)
 {
-	int y,x;
-
-	int x0 = vMap.w2mClampX(PositionX - TERRAFORM_ELEMENT_SIDE);
-	int y0 = vMap.w2mClampY(PositionY - TERRAFORM_ELEMENT_SIDE);
-	int x1 = vMap.w2mClampX(PositionX + TERRAFORM_ELEMENT_SIDE);
-	int y1 = vMap.w2mClampY(PositionY + TERRAFORM_ELEMENT_SIDE);
+	UpdateMasks();
+	if(!FillMask)
+		return 0;
 
 	MetaRegionLock lock(Player->RegionPoint);
 	RegionDispatcher* region = Player->ZeroRegionPoint.data();
-
-	int lx = -1;
-	int ly = -1;
-	x=(x0+x1)/2;
-	y=(y0+y1)/2;
-	if(region->filledRasterized(Vect2i(vMap.XCYCL(vMap.m2wHalf(x)), vMap.YCYCL(vMap.m2wHalf(y))))){
-		unsigned short p = vMap.GABuf[vMap.offsetGBuf(x, y)];
-		if((!GRIDTST_LEVELED(p) && !GRIDTST_TALLER_HZEROPLAST(p)) || (GRIDTST_LEVELED(p) && (p & GRIDAT_BASE_OF_BUILDING_CORRUPT))){
-			lx = vMap.m2wHalf(x);
-			ly = vMap.m2wHalf(y);
-			if(lx != cx || ly != cy){
-				cx = lx;
-				cy = ly;
-				return 1;
-			}
-		}
-	}
-
-	for(y = y0;y <= y1;y++){
-		for(x = x0;x <= x1;x++){
-			if(region->filledRasterized(Vect2i(vMap.XCYCL(vMap.m2wHalf(x)), vMap.YCYCL(vMap.m2wHalf(y))))){
-				unsigned short p = vMap.GABuf[vMap.offsetGBuf(x, y)];
-				if((!GRIDTST_LEVELED(p) && !GRIDTST_TALLER_HZEROPLAST(p)) || (GRIDTST_LEVELED(p) && (p & GRIDAT_BASE_OF_BUILDING_CORRUPT))){
-					lx = vMap.m2wHalf(x);
-					ly = vMap.m2wHalf(y);
-					if(lx != cx || ly != cy){
-						cx = lx;
-						cy = ly;
-						return 1;
-					}
-				}
-			}
-		}
-	}
-
-	if(lx != -1 && ly != -1){
-		cx = lx;
-		cy = ly;
-		return 1;
-	}
-	return 0;
+	return FindMaskPosition(FillMask, true, cx, cy, region);
 }
 
 int terTerraformBorder::GetZeroPosition(int& cx,int& cy)
 {
-	int y,x;
-
-	int x0 = vMap.w2mClampX(PositionX - TERRAFORM_ELEMENT_SIDE);
-	int y0 = vMap.w2mClampY(PositionY - TERRAFORM_ELEMENT_SIDE);
-	int x1 = vMap.w2mClampX(PositionX + TERRAFORM_ELEMENT_SIDE);
-	int y1 = vMap.w2mClampY(PositionY + TERRAFORM_ELEMENT_SIDE);
-	
-	int lx = -1;
-	int ly = -1;
+	UpdateMasks();
+	if(!ZeroMask)
+		return 0;
 
 	MetaRegionLock lock(Player->RegionPoint);
 	RegionDispatcher* region = Player->ZeroRegionPoint.data();
-
-	for(y = y0;y <= y1;y++){
-		for(x = x0;x <= x1;x++){
-			if(region->filledRasterized(Vect2i(vMap.XCYCL(vMap.m2wHalf(x)), vMap.YCYCL(vMap.m2wHalf(y))))){
-				unsigned short p = vMap.GABuf[vMap.offsetGBuf(x, y)];
-				if(!GRIDTST_ZEROPLAST(p) && GRIDTST_LEVELED(p)){
-					lx = vMap.m2wHalf(x);
-					ly = vMap.m2wHalf(y);
-					if(lx != cx || ly != cy){
-						cx = lx;
-						cy = ly;
-						return 1;
-					}
-				}
-			}
-		}
-	}
-
-	if(lx != -1 && ly != -1){
-		cx = lx;
-		cy = ly;
-		return 1;
-	}
-	return 0;
+	return FindMaskPosition(ZeroMask, false, cx, cy, region);
 }
 
 int terTerraformBorder::GetClusterAttribute(int cx,int cy,int sx,int sy,int& prepared_zero,int& resource_zero,int& dig_layer,int& fill_layer,int& ground_zero,int& cell,int& zero_present)
@@ -647,6 +504,94 @@ int terTerraformBorder::CheckZeroPosition(int cx,int cy)
 
 //--------------------------------------------------
 
+terTerraformIndex::terTerraformIndex()
+{
+	SizeX = SizeY = 0;
+	Count = 0;
+}
+
+void terTerraformIndex::Init(int sx, int sy)
+{
+	SizeX = max((sx + (1 << TERRAFORM_INDEX_CELL_SHIFT) - 1) >> TERRAFORM_INDEX_CELL_SHIFT, 1);
+	SizeY = max((sy + (1 << TERRAFORM_INDEX_CELL_SHIFT) - 1) >> TERRAFORM_INDEX_CELL_SHIFT, 1);
+	Cells.clear();
+	Cells.resize(SizeX*SizeY);
+	Count = 0;
+}
+
+void terTerraformIndex::Clear()
+{
+	for(auto& cell : Cells)
+		cell.clear();
+	Count = 0;
+}
+
+void terTerraformIndex::Insert(terTerraformGeneral* element)
+{
+	Cells[CellY(element->PositionY)*SizeX + CellX(element->PositionX)].push_back(element);
+	Count++;
+}
+
+void terTerraformIndex::Remove(terTerraformGeneral* element)
+{
+	Cell& cell = Cells[CellY(element->PositionY)*SizeX + CellX(element->PositionX)];
+	Cell::iterator it = std::find(cell.begin(), cell.end(), element);
+	xassert(it != cell.end());
+	if(it == cell.end())
+		return;
+	*it = cell.back();
+	cell.pop_back();
+	Count--;
+}
+
+terTerraformGeneral* terTerraformIndex::FindNear(int TerraformTypes, terTerraformStatus status, int x, int y, int id) const
+{
+	if(!Count)
+		return 0;
+
+	int cx = CellX(x);
+	int cy = CellY(y);
+	int max_radius = max(max(cx, SizeX - 1 - cx), max(cy, SizeY - 1 - cy));
+
+	terTerraformGeneral* p = NULL;
+	int md = 0;
+	for(int r = 0; r <= max_radius; r++){
+		//Ближе чем (r-1) клетка до кольца r не достать
+		if(p && r > 1 && sqr((r - 1) << TERRAFORM_INDEX_CELL_SHIFT) > md)
+			break;
+
+		int y0 = max(cy - r, 0);
+		int y1 = min(cy + r, SizeY - 1);
+		for(int yy = y0; yy <= y1; yy++){
+			bool full_row = yy == cy - r || yy == cy + r;
+			int step = full_row || r == 0 ? 1 : 2*r;
+			for(int xx = cx - r; xx <= cx + r; xx += step){
+				if(xx < 0 || xx >= SizeX)
+					continue;
+				const Cell& cell = Cells[yy*SizeX + xx];
+				Cell::const_iterator ti;
+				FOR_EACH(cell, ti){
+					terTerraformGeneral& t = **ti;
+					if( (t.Type | TerraformTypes) && 
+						(id == -1 || t.ID == id) && 
+						!t.UnitPoint && (t.Status & status)
+					  )
+					{
+						int d = sqr(x - t.PositionX) + sqr(y - t.PositionY);
+						if(!p || d < md || (d == md && t.IndexOrder > p->IndexOrder)){
+							md = d;
+							p = &t;
+						}
+					}
+				}
+			}
+		}
+	}
+	return p;
+}
+
+//--------------------------------------------------
+
 terTerraformDispatcher::terTerraformDispatcher(terPlayer* player)
 : TrustGrid(vMap.H_SIZE, vMap.V_SIZE)
 {
@@ -656,6 +601,10 @@ terTerraformDispatcher::terTerraformDispatcher(terPlayer* player)
 	zero_complete = 0;
 	abyss_request = 0;
 	abyss_complete = 0;
+
+	IndexOrder = 0;
+	DigIndex.Init(vMap.H_SIZE, vMap.V_SIZE);
+	FillIndex.Init(vMap.H_SIZE, vMap.V_SIZE);
 }
 
 terTerraformDispatcher::~terTerraformDispatcher()
@@ -664,6 +613,7 @@ terTerraformDispatcher::~terTerraformDispatcher()
 	FOR_EACH(TerraformsDigFill, ti)
 	{
 		TrustGrid.Remove(**ti);
+		UpdateIndex(*ti, 0);
 	}
 	TerraformsDigFill.clear();
 	FOR_EACH(TerraformsOther, ti)
@@ -796,6 +746,7 @@ TerraformList::iterator terTerraformDispatcher::DeleteElement(TerraformList::ite
 		xassert(0);
 	}
 	(*ti)->ChangeStatus(this,(*ti)->Status,TERRAFORM_STATUS_DIG);
+	UpdateIndex(*ti, 0);
 
 	bool is=(*ti)->IsDigFill();
 	if(is)
@@ -874,31 +825,29 @@ void terTerraformDispatcher::ScanTrustMap(int& request_digger,int& request_fille
 
 terTerraformGeneral* terTerraformDispatcher::FindNear(int TerraformTypes, terTerraformStatus status, int x,int y, int id)
 {
-//	int size_df=TerraformsDigFill.size();
-//	int size_oter=TerraformsOther.size();
 	xassert(status==TERRAFORM_STATUS_DIG || status==TERRAFORM_STATUS_FILL);
 
-	terTerraformGeneral* p = NULL;
-	int md = 0;
-	TerraformList::iterator ti;
-	FOR_EACH(TerraformsDigFill, ti){
-		terTerraformGeneral& t = **ti;
-		if( (t.Type | TerraformTypes) && 
-			(id == -1 || t.ID == id) && 
-			!t.UnitPoint && (t.Status & status)
-		  )
-		{
-			int d = sqr(x - t.PositionX) + sqr(y - t.PositionY);			
-			if(d < md || !p){
-				md = d;
-				p = &t;
-			}
-		}
-	}
-	if(p) 
-		return p;
+	if(status == TERRAFORM_STATUS_DIG)
+		return DigIndex.FindNear(TerraformTypes, status, x, y, id);
+	return FillIndex.FindNear(TerraformTypes, status, x, y, id);
+}
 
-	return 0;
+void terTerraformDispatcher::UpdateIndex(terTerraformGeneral* element, int status)
+{
+	int changed = element->IndexStatus ^ status;
+	if(changed & TERRAFORM_STATUS_DIG){
+		if(status & TERRAFORM_STATUS_DIG)
+			DigIndex.Insert(element);
+		else
+			DigIndex.Remove(element);
+	}
+	if(changed & TERRAFORM_STATUS_FILL){
+		if(status & TERRAFORM_STATUS_FILL)
+			FillIndex.Insert(element);
+		else
+			FillIndex.Remove(element);
+	}
+	element->IndexStatus = status;
 }
 
 terTerraformGeneral* terTerraformDispatcher::FindNearDigger(int x,int y)
@@ -1040,6 +989,94 @@ int terDigScanGarbageCheck(int x, int y, RegionMetaDispatcher* region, terPlayer
 const int TRUST_MAP_NOISE_SIDE = 128;
 const int TRUST_MAP_NOISE_SIZE = TRUST_MAP_NOISE_SIDE * 2;
 
+//Число ячеек сетки, годных под мусор (terDigGarbageMapTest == 0), в блоках vMap.gridRevision.
+//Блок пересчитывается только когда vMap отметил изменение сетки в нем.
+class terGarbageMap
+{
+public:
+	terGarbageMap() { SizeX = SizeY = 0; }
+
+	//Мировые координаты, циклятся
+	bool HasGarbage(int x0,int y0,int x1,int y1)
+	{
+		if(SizeX != (vMap.H_SIZE >> kmGridChA) || SizeY != (vMap.V_SIZE >> kmGridChA)){
+			SizeX = vMap.H_SIZE >> kmGridChA;
+			SizeY = vMap.V_SIZE >> kmGridChA;
+			Count.assign(SizeX*SizeY, 0);
+			Revision.assign(SizeX*SizeY, 0);
+		}
+
+		int bx0 = vMap.XCYCL(x0) >> kmGridChA;
+		int by0 = vMap.YCYCL(y0) >> kmGridChA;
+		int nx = min(((vMap.XCYCL(x0) & (sizeCellGridCA - 1)) + x1 - x0) >> kmGridChA, SizeX - 1) + 1;
+		int ny = min(((vMap.YCYCL(y0) & (sizeCellGridCA - 1)) + y1 - y0) >> kmGridChA, SizeY - 1) + 1;
+		for(int j = 0;j < ny;j++)
+			for(int i = 0;i < nx;i++)
+				if(BlockGarbage((bx0 + i) & (SizeX - 1), (by0 + j) & (SizeY - 1)))
+					return true;
+		return false;
+	}
+
+private:
+	std::vector<unsigned short> Count;
+	std::vector<unsigned int> Revision;
+	int SizeX,SizeY;
+
+	int BlockGarbage(int bx,int by)
+	{
+		const int side = 1 << (kmGridChA - kmGrid);
+		int xg0 = bx*side;
+		int yg0 = by*side;
+		int index = by*SizeX + bx;
+		if(Revision[index] && vMap.getGridRevision(xg0, yg0, xg0 + side - 1, yg0 + side - 1) <= Revision[index])
+			return Count[index];
+
+		int count = 0;
+		for(int y = yg0;y < yg0 + side;y++){
+			int offset = vMap.offsetGBuf(xg0, y);
+			for(int x = 0;x < side;x++){
+				unsigned short p = vMap.GABuf[offset + x];
+				if(!GRIDTST_LEVELED(p) && IsNoHardness(p) && vMap.GVBuf[offset + x] != 0)
+					count++;
+			}
+		}
+		Count[index] = count;
+		Revision[index] = vMap.gridRevisionCounter;
+		return count;
+	}
+};
+
+static terGarbageMap garbageMap;
+
+//Есть ли мусор там, куда могут попасть пробы периметра terDigScanGarbage/terFillScanGarbage
+static bool terScanGarbageBands(int x0,int y0,int x1,int y1)
+{
+	const int side = TRUST_MAP_NOISE_SIDE;
+	return garbageMap.HasGarbage(x0 - side, y0 - side, x1 + side, y0 + side) ||
+		garbageMap.HasGarbage(x0 - side, y1 - side, x1 + side, y1 + side) ||
+		garbageMap.HasGarbage(x0 - side, y0 - side, x0 + side, y1 + side) ||
+		garbageMap.HasGarbage(x1 - side, y0 - side, x1 + side, y1 + side);
+}
+
+//Пустое кольцо тратит столько же logicRND, сколько полный перебор проб,
+//иначе поток случайных чисел разойдется с прежними записями и сетевой игрой
+static void terScanGarbageSkip(int x0,int y0,int x1,int y1)
+{
+	int i;
+	for(i = x0;i <= x1;i += (4 << kmGrid)){
+		terLogicRND(TRUST_MAP_NOISE_SIZE);
+		terLogicRND(TRUST_MAP_NOISE_SIZE);
+		terLogicRND(TRUST_MAP_NOISE_SIZE);
+		terLogicRND(TRUST_MAP_NOISE_SIZE);
+	}
+	for(i = y0;i <= y1;i += (4 << kmGrid)){
+		terLogicRND(TRUST_MAP_NOISE_SIZE);
+		terLogicRND(TRUST_MAP_NOISE_SIZE);
+		terLogicRND(TRUST_MAP_NOISE_SIZE);
+		terLogicRND(TRUST_MAP_NOISE_SIZE);
+	}
+}
+
 int terDigScanGarbage(int cx,int cy,int sx,int sy,int& x,int& y,class RegionMetaDispatcher* region,terPlayer* player)
 {
 	int i;
@@ -1063,6 +1100,11 @@ int terDigScanGarbage(int cx,int cy,int sx,int sy,int& x,int& y,class RegionMeta
 	if(y1 < 0) y0 = 0;
 	else if(y1 >= vMap.V_SIZE) y1 = vMap.V_SIZE - 1;
 
+	if(!terScanGarbageBands(x0,y0,x1,y1)){
+		terScanGarbageSkip(x0,y0,x1,y1);
+		return 0;
+	}
+
 	for(i = x0;i <= x1;i += (4 << kmGrid)){
 		rx = vMap.XCYCL(i - TRUST_MAP_NOISE_SIDE + terLogicRND(TRUST_MAP_NOISE_SIZE));
 		ry = vMap.YCYCL(y0 - TRUST_MAP_NOISE_SIDE + terLogicRND(TRUST_MAP_NOISE_SIZE));
@@ -1216,6 +1258,11 @@ int terFillScanGarbage(int cx,int cy,int sx,int sy,int& x,int& y,class RegionMet
 	if(y1 < 0) y0 = 0;
 	else if(y1 >= vMap.V_SIZE) y1 = vMap.V_SIZE - 1;
 
+	if(!terScanGarbageBands(x0,y0,x1,y1)){
+		terScanGarbageSkip(x0,y0,x1,y1);
+		return 0;
+	}
+
 	for(i = x0;i <= x1;i += (4 << kmGrid)){
 		rx = vMap.XCYCL(i - TRUST_MAP_NOISE_SIDE + terLogicRND(TRUST_MAP_NOISE_SIZE));
 		ry = vMap.YCYCL(y0 - TRUST_MAP_NOISE_SIDE + terLogicRND(TRUST_MAP_NOISE_SIZE));
@@ -69,6 +69,9 @@ struct terTerraformGeneral : GridElementType, SharedObject
 
 	terPlayer* Player;
 
+	int IndexStatus; //В каких индексах диспетчера лежит (TERRAFORM_STATUS_DIG|TERRAFORM_STATUS_FILL)
+	unsigned int IndexOrder; //Порядок добавления в TerraformsDigFill, из равноудаленных выбирается последний
+
 	terTerraformGeneral(int id,int x,int y,terPlayer* player);
 	~terTerraformGeneral() override;
 
@@ -126,6 +129,18 @@ struct terTerraformFull : terTerraformGeneral
 
 	int GetClusterAttribute(int cx,int cy,int sx,int sy,int& prepared_zero,int& resource_zero,int& dig_layer,int& fill_layer,int& ground_zero,int& cell,int& zero_present);
 	int GetHeight(){ return Height; };
+
+protected:
+	//Маски ячеек сетки квадрата элемента (построчно от MaskX0,MaskY0),
+	//пересчитываются только если vMap поменял сетку под элементом
+	uint64_t DigMask, FillMask, ZeroMask;
+	int MaskX0, MaskY0, MaskSX, MaskSY;
+	unsigned int MaskRevision;
+	bool MaskValid;
+
+	void UpdateMasks();
+	//Сначала центр (если center_first), потом первая ячейка отличная от cx,cy, иначе текущая
+	int FindMaskPosition(uint64_t mask, bool center_first, int& cx, int& cy, RegionDispatcher* region = 0);
 };
 
 struct terTerraformBorder : terTerraformFull
@@ -194,6 +209,31 @@ const int TRUST_MAP_GARBAGE_SIZE = 16;
 const int TRUST_MAP_GARBAGE_TEST_SIZE = 32;
 const int TRUST_MAP_GARBAGE_LEVEL = 128;
 
+// Элементы TerraformsDigFill по клеткам карты, поиск ближайшего идет кольцами клеток от точки
+const int TERRAFORM_INDEX_CELL_SHIFT = 6;
+
+class terTerraformIndex
+{
+public:
+	terTerraformIndex();
+	void Init(int sx, int sy);
+	void Clear();
+
+	void Insert(terTerraformGeneral* element);
+	void Remove(terTerraformGeneral* element);
+
+	terTerraformGeneral* FindNear(int TerraformTypes, terTerraformStatus status, int x, int y, int id) const;
+
+private:
+	typedef std::vector<terTerraformGeneral*> Cell;
+	std::vector<Cell> Cells;
+	int SizeX, SizeY;
+	int Count;
+
+	int CellX(int x) const { return clamp(x >> TERRAFORM_INDEX_CELL_SHIFT, 0, SizeX - 1); }
+	int CellY(int y) const { return clamp(y >> TERRAFORM_INDEX_CELL_SHIFT, 0, SizeY - 1); }
+};
+
 class terTerraformDispatcher
 {
 public:
@@ -225,6 +265,10 @@ private:
 	TerraformList TerraformsDigFill,TerraformsOther;
 	friend terTerraformGeneral;
 
+	terTerraformIndex DigIndex,FillIndex;
+	unsigned int IndexOrder;
+	void UpdateIndex(terTerraformGeneral* element, int status);
+
 	terTerraformGeneral* FindNear(int TerraformTypes, terTerraformStatus status, int x,int y, int id = -1);
 	TerraformList::iterator DeleteElement(TerraformList::iterator ti);
 
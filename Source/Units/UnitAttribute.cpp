@@ -388,7 +388,12 @@ std::string GetBelligerentTexturePath(terBelligerent belligerent)
 
 cObjectNodeRoot* createObject(const char* name, terBelligerent belligerent)
 {
-	std::string path=GetBelligerentTexturePath(belligerent);
+	//Only few distinct paths exist, build them once instead of per spawned model
+	static std::string paths[BELLIGERENT_COUNT];
+	std::string& path = paths[belligerent];
+	if (path.empty()) {
+		path = GetBelligerentTexturePath(belligerent);
+	}
 	cObjectNodeRoot* model = terScene->CreateObject(name, path.c_str());
 	xassert(model);
 	return model;
@@ -730,6 +735,38 @@ void AttributeBase::initIntfBalanceData(const AttributeBase* missile)
 	}
 }
 
+//Dense [belligerent][ID] table, BELLIGERENT_NONE fallback is already resolved
+static std::vector<const AttributeBase*> attributeTable;
+
+static void buildAttributeTable() {
+    attributeTable.assign(BELLIGERENT_COUNT * UNIT_ATTRIBUTE_MAX, nullptr);
+    for (auto& i : attributeLibrary()) {
+        terUnitAttributeID id = i.first.attributeID();
+        terBelligerent belligerent = i.first.belligerent();
+        if (id < 0 || UNIT_ATTRIBUTE_MAX <= id || belligerent < 0 || BELLIGERENT_COUNT <= belligerent) continue;
+        attributeTable[belligerent * UNIT_ATTRIBUTE_MAX + id] = i.second;
+    }
+    for (int belligerent = 1; belligerent < BELLIGERENT_COUNT; belligerent++) {
+        for (int id = 0; id < UNIT_ATTRIBUTE_MAX; id++) {
+            const AttributeBase*& attr = attributeTable[belligerent * UNIT_ATTRIBUTE_MAX + id];
+            if (!attr) {
+                attr = attributeTable[BELLIGERENT_NONE * UNIT_ATTRIBUTE_MAX + id];
+            }
+        }
+    }
+}
+
+const AttributeBase* findUnitAttribute(terUnitAttributeID id, terBelligerent belligerent) {
+    if (0 <= id && id < UNIT_ATTRIBUTE_MAX && 0 <= belligerent && belligerent < BELLIGERENT_COUNT && !attributeTable.empty()) {
+        return attributeTable[belligerent * UNIT_ATTRIBUTE_MAX + id];
+    }
+    const AttributeBase* attr = attributeLibrary().find(AttributeIDBelligerent(id, belligerent));
+    if (!attr) {
+        attr = attributeLibrary().find(AttributeIDBelligerent(id, BELLIGERENT_NONE));
+    }
+    return attr;
+}
+
 void copyAttributes(bool);
 void copyInterfaceAttributes();
 void copyRigidBodyTable(bool);
@@ -869,6 +906,8 @@ void loadUnitAttributes(bool campaign, XBuffer* scriptsSerialized) {
 //	interfaceAttr.edit();
 //	ErrH.Exit();
 
+    buildAttributeTable();
+
     if (!scriptsSerialized) {
         collect_content_crc();
     }
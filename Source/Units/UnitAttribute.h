@@ -1720,6 +1720,9 @@ typedef TypeLibrary<AttributeIDBelligerent, AttributeBase> AttributeLibrary;
 extern SingletonPrm<AttributeLibrary> attributeLibrary;
 void loadUnitAttributes(bool campaign, XBuffer* scriptsSerialized);
 void initUnitAttributes();
+const int BELLIGERENT_COUNT = BELLIGERENT_EMPIRE4 + 1;
+///Attribute for belligerent or common one if belligerent has no own, without map lookups
+const AttributeBase* findUnitAttribute(terUnitAttributeID id, terBelligerent belligerent);
 uint32_t get_content_crc();
 const std::map<std::string, uint32_t>& get_content_list();
 
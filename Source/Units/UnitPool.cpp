@@ -0,0 +1,186 @@
+#include "StdAfx.h"
+#include "UnitPool.h"
+#include "RenderMT.h"
+
+//Objects up to this size are pooled, rest go to global heap with same header
+static const size_t POOL_GRANULARITY = 32;
+static const size_t POOL_MAX_OBJECT_SIZE = 8192;
+static const size_t POOL_SIZE_CLASSES = POOL_MAX_OBJECT_SIZE / POOL_GRANULARITY;
+static const uint32_t POOL_OVERSIZE_CLASS = 0xFFFF;
+static const size_t POOL_SLAB_BYTES = 64 * 1024;
+static const size_t POOL_MIN_SLAB_OBJECTS = 8;
+
+//Placed before every object, keeps object aligned as global new would do
+struct alignas(16) UnitPoolSlot
+{
+	uint32_t slot;
+	uint32_t sizeClass;
+	uint32_t live;
+};
+
+struct UnitPoolSlab
+{
+	char* memory = nullptr;
+	uint32_t liveCount = 0;
+};
+
+class UnitSizeClassPool
+{
+public:
+	size_t stride = 0;
+	uint32_t slabObjects = 0;
+	std::vector<UnitPoolSlab> slabs;
+	std::vector<uint32_t> freeSlots;
+	size_t live = 0;
+
+	UnitPoolSlot* slotAt(uint32_t slot) const {
+		const UnitPoolSlab& slab = slabs[slot / slabObjects];
+		if (!slab.memory) {
+			return nullptr;
+		}
+		return reinterpret_cast<UnitPoolSlot*>(slab.memory + (slot % slabObjects) * stride);
+	}
+
+	void addSlab(uint32_t sizeClass) {
+		uint32_t slab_index = 0;
+		while (slab_index < slabs.size() && slabs[slab_index].memory) {
+			slab_index++;
+		}
+		if (slab_index == slabs.size()) {
+			slabs.emplace_back();
+		}
+		UnitPoolSlab& slab = slabs[slab_index];
+		slab.memory = static_cast<char*>(::operator new(stride * slabObjects));
+		slab.liveCount = 0;
+
+		//Push in reverse so lowest addresses are handed out first
+		uint32_t first = slab_index * slabObjects;
+		for (uint32_t i = slabObjects; i > 0; i--) {
+			UnitPoolSlot* header = reinterpret_cast<UnitPoolSlot*>(slab.memory + (i - 1) * stride);
+			header->slot = first + i - 1;
+			header->sizeClass = sizeClass;
+			header->live = 0;
+			freeSlots.push_back(first + i - 1);
+		}
+	}
+
+	void releaseUnused() {
+		bool released = false;
+		for (UnitPoolSlab& slab : slabs) {
+			if (slab.memory && slab.liveCount == 0) {
+				::operator delete(slab.memory);
+				slab.memory = nullptr;
+				released = true;
+			}
+		}
+		if (released) {
+			freeSlots.erase(std::remove_if(freeSlots.begin(), freeSlots.end(), [this](uint32_t slot) {
+				return !slabs[slot / slabObjects].memory;
+			}), freeSlots.end());
+			while (!slabs.empty() && !slabs.back().memory) {
+				slabs.pop_back();
+			}
+		}
+	}
+};
+
+static MTSection& unitPoolLock()
+{
+	static MTSection* lock = new MTSection();
+	return *lock;
+}
+
+//Never destroyed, units may still be released during static destruction
+static UnitSizeClassPool* const unitPools = new UnitSizeClassPool[POOL_SIZE_CLASSES];
+static size_t unitPoolOversizeLive = 0;
+
+void* UnitPool::alloc(size_t size)
+{
+	size_t total = sizeof(UnitPoolSlot) + size;
+	if (POOL_MAX_OBJECT_SIZE < size) {
+		UnitPoolSlot* header = static_cast<UnitPoolSlot*>(::operator new(total));
+		header->slot = 0;
+		header->sizeClass = POOL_OVERSIZE_CLASS;
+		header->live = 1;
+		MTAuto lock(&unitPoolLock());
+		unitPoolOversizeLive++;
+		return header + 1;
+	}
+
+	uint32_t sizeClass = static_cast<uint32_t>((size + POOL_GRANULARITY - 1) / POOL_GRANULARITY) - 1;
+	MTAuto lock(&unitPoolLock());
+	UnitSizeClassPool& pool = unitPools[sizeClass];
+	if (!pool.stride) {
+		pool.stride = sizeof(UnitPoolSlot) + (sizeClass + 1) * POOL_GRANULARITY;
+		pool.slabObjects = static_cast<uint32_t>(std::max(POOL_MIN_SLAB_OBJECTS, POOL_SLAB_BYTES / pool.stride));
+	}
+	if (pool.freeSlots.empty()) {
+		pool.addSlab(sizeClass);
+	}
+
+	uint32_t slot = pool.freeSlots.back();
+	pool.freeSlots.pop_back();
+	UnitPoolSlot* header = pool.slotAt(slot);
+	xassert(header && !header->live);
+	header->live = 1;
+	pool.slabs[slot / pool.slabObjects].liveCount++;
+	pool.live++;
+	return header + 1;
+}
+
+void UnitPool::free(void* ptr)
+{
+	if (!ptr) {
+		return;
+	}
+	UnitPoolSlot* header = static_cast<UnitPoolSlot*>(ptr) - 1;
+	xassert(header->live);
+	MTAuto lock(&unitPoolLock());
+	header->live = 0;
+
+	if (header->sizeClass == POOL_OVERSIZE_CLASS) {
+		unitPoolOversizeLive--;
+		::operator delete(header);
+		return;
+	}
+
+	UnitSizeClassPool& pool = unitPools[header->sizeClass];
+	pool.slabs[header->slot / pool.slabObjects].liveCount--;
+	pool.live--;
+	pool.freeSlots.push_back(header->slot);
+}
+
+void UnitPool::releaseUnused()
+{
+	MTAuto lock(&unitPoolLock());
+	for (size_t i = 0; i < POOL_SIZE_CLASSES; i++) {
+		UnitSizeClassPool& pool = unitPools[i];
+		pool.releaseUnused();
+	}
+}
+
+size_t UnitPool::liveObjects()
+{
+	MTAuto lock(&unitPoolLock());
+	size_t count = unitPoolOversizeLive;
+	for (size_t i = 0; i < POOL_SIZE_CLASSES; i++) {
+		const UnitSizeClassPool& pool = unitPools[i];
+		count += pool.live;
+	}
+	return count;
+}
+
+size_t UnitPool::reservedBytes()
+{
+	MTAuto lock(&unitPoolLock());
+	size_t bytes = 0;
+	for (size_t i = 0; i < POOL_SIZE_CLASSES; i++) {
+		const UnitSizeClassPool& pool = unitPools[i];
+		for (const UnitPoolSlab& slab : pool.slabs) {
+			if (slab.memory) {
+				bytes += pool.stride * pool.slabObjects;
+			}
+		}
+	}
+	return bytes;
+}
@@ -0,0 +1,25 @@
+#ifndef __UNIT_POOL_H__
+#define __UNIT_POOL_H__
+
+//-----------------------------------------
+//	Slab memory for units
+//
+// Units, projectiles and corpses are allocated from per size class slabs,
+// so objects of the same class live next to each other and slots are reused
+// instead of going to the global heap.
+
+class UnitPool
+{
+public:
+	static void* alloc(size_t size);
+	static void free(void* ptr);
+
+	//Frees slabs without live objects
+	static void releaseUnused();
+
+	// Debug
+	static size_t liveObjects();
+	static size_t reservedBytes();
+};
+
+#endif //__UNIT_POOL_H__
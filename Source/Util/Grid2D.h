@@ -105,7 +105,7 @@ class Grid2D : GridPassDispatcher
 public:	
 
 	Grid2D(int map_sx,int map_sy)
-	: cell_table(0)
+	: cell_table(0), changes_(0)
 	{
 		Set(map_sx,map_sy);
 	}
@@ -121,6 +121,7 @@ public:
 
 		size_x = map_sx / cell_size;
 		size_y = map_sy / cell_size;
+		changes_++;
 		//m_mask_x = size_x - 1;
 		//m_mask_y = size_y - 1;
 	
@@ -135,6 +136,7 @@ public:
 		GridRectangle rect(xc - side, yc - side, xc + side, yc + side);
 		prepRectangle(rect);
 		setRectangle(obj, rect);
+		changes_++;
 		for(int y = rect.y0;y <= rect.y1;y++)
 			for(int x = rect.x0;x <= rect.x1;x++)
 				if(obj.belongSquare(x*cell_size, y*cell_size, cell_size, cell_size))
@@ -158,6 +160,7 @@ public:
 		xassert(!obj.inserted() && "Grid: incomplete remove in Move");
 
 		setRectangle(obj, rect);
+		changes_++;
 		for(int y = rect.y0;y <= rect.y1;y++)
 			for(int x = rect.x0;x <= rect.x1;x++)
 				if(obj.belongSquare(x*cell_size, y*cell_size, cell_size, cell_size))
@@ -175,10 +178,12 @@ public:
 					table(x, y).remove(&obj);
 
 		xassert(!obj.inserted() && "Grid: incomplete remove in Remove");
+		changes_++;
 	}
 
 	void Clear()
 	{
+		changes_++;
 		for(int y = 0;y < size_y;y++)
 			for(int x = 0;x < size_x;x++){
 				cell_table[y][x].clear();
@@ -219,6 +224,49 @@ public:
 			}
 	}
 
+	////////////////////////////////////////////////////////////////////////////////////
+	//   Выборка - копия клеток только с частью объектов.
+	//   Порядок в клетках тот же, поэтому ScanSubset перебирает объекты в том же
+	//   порядке, что и Scan, пропуская не попавшие в выборку.
+	//   Выборка устаревает при любом изменении сетки, см. changes()
+	////////////////////////////////////////////////////////////////////////////////////
+	typedef std::vector<std::vector<T*> > Subset;
+
+	int changes() const { return changes_; }
+
+	template <class Filter>
+	void BuildSubset(Subset& subset, Filter& filter) const
+	{
+		subset.resize(size_x*size_y);
+		for(int y = 0;y < size_y;y++)
+			for(int x = 0;x < size_x;x++){
+				std::vector<T*>& cell = subset[y*size_x + x];
+				cell.clear();
+				CellList& root = table(x, y);
+				typename CellList::iterator i;
+				FOR_EACH(root, i)
+					if(filter(*i))
+						cell.push_back(*i);
+			}
+	}
+
+	template <class Op>
+	void ScanSubset(const Subset& subset, int xc, int yc, int side, Op& op) const
+	{
+		xassert(subset.size() == size_x*size_y);
+		beginPass();
+		GridRectangle rect(xc - side, yc - side, xc + side, yc + side);
+		prepRectangle(rect);
+		for(int y = rect.y0;y <= rect.y1;y++)
+			for(int x = rect.x0;x <= rect.x1;x++){
+				const std::vector<T*>& cell = subset[y*size_x + x];
+				typename std::vector<T*>::const_iterator i;
+				FOR_EACH(cell, i)
+					if(doPass(**i))
+						op(*i);
+			}
+	}
+
 	template <class Op>
 	int ConditionScan(int xc, int yc, int side, Op& op) const { return ConditionScan(xc - side, yc - side, xc + side, yc + side, op); }
 
@@ -753,6 +801,7 @@ private:
  	CellList** cell_table;
 
 	int size_x, size_y;
+	int changes_;
 //	int m_mask_x, m_mask_y;
 
 	// Реализован Clamped-режим:
@@ -0,0 +1,241 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//	Deterministic fixed-point math
+//
+//	16.16 fixed-point scalar, 2D/3D vectors, sqrt and trigonometry
+//	implemented with integer arithmetic only. Results are bit exact on every
+//	compiler, architecture and optimization level, so simulation code that
+//	uses these types doesn't depend on floating point compiler flags.
+//
+//	xfixed holds [-32768, 32768) with 1/65536 step. Conversion from int,
+//	multiplication by int, vector norm() and dot() saturate outside of it, squared lengths are returned as int64_t with
+//	16 fractional bits (norm2, distance2, xfx::sqr) and are exact for any
+//	components.
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef __XFIXED_H__
+#define __XFIXED_H__
+
+#include "xmath.h"
+#include "xerrhand.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//			class xfixed
+//
+///////////////////////////////////////////////////////////////////////////////
+
+class xfixed
+{
+public:
+	enum {
+		FRACTION_BITS = 16,
+		ONE = 1 << FRACTION_BITS,
+		HALF = ONE >> 1
+	};
+
+	int32_t raw = 0;
+
+	xm_inline xfixed() = default;
+	xm_inline xfixed(int v)								{ raw = fromRaw64(static_cast<int64_t>(v) * ONE).raw; }
+	xm_inline explicit xfixed(float f)					{ raw = xm::round(f * static_cast<float>(ONE)); }
+	xm_inline explicit xfixed(double f)					{ raw = static_cast<int32_t>(xm::round(f * static_cast<double>(ONE))); }
+
+	xm_inline static xfixed fromRaw(int32_t r)			{ xfixed f; f.raw = r; return f; }
+	///Clamps 64 bit raw value into xfixed range, asserts on overflow
+	xm_inline static xfixed fromRaw64(int64_t r) {
+		xassert(INT32_MIN <= r && r <= INT32_MAX);
+		return fromRaw(static_cast<int32_t>(r < INT32_MIN ? INT32_MIN : (INT32_MAX < r ? INT32_MAX : r)));
+	}
+	xm_inline static xfixed fromRatio(int num, int den)	{ return fromRaw(static_cast<int32_t>((static_cast<int64_t>(num) << FRACTION_BITS) / den)); }
+
+	xm_inline float toFloat() const						{ return static_cast<float>(raw) / static_cast<float>(ONE); }
+	xm_inline int floor() const							{ return raw >> FRACTION_BITS; }
+	xm_inline int ceil() const							{ return static_cast<int>((static_cast<int64_t>(raw) + ONE - 1) >> FRACTION_BITS); }
+	xm_inline int round() const							{ return static_cast<int>((static_cast<int64_t>(raw) + HALF) >> FRACTION_BITS); }
+
+	xm_inline xfixed operator - () const				{ return fromRaw(-raw); }
+
+	xm_inline xfixed& operator += (xfixed f)			{ raw += f.raw; return *this; }
+	xm_inline xfixed& operator -= (xfixed f)			{ raw -= f.raw; return *this; }
+	xm_inline xfixed& operator *= (xfixed f)			{ raw = static_cast<int32_t>((static_cast<int64_t>(raw) * f.raw) >> FRACTION_BITS); return *this; }
+	xm_inline xfixed& operator /= (xfixed f)			{ raw = f.raw ? static_cast<int32_t>((static_cast<int64_t>(raw) << FRACTION_BITS) / f.raw) : (raw < 0 ? -INT_INF : INT_INF); return *this; }
+	xm_inline xfixed& operator *= (int i)				{ raw = fromRaw64(static_cast<int64_t>(raw) * i).raw; return *this; }
+	xm_inline xfixed& operator /= (int i)				{ raw /= i; return *this; }
+	xm_inline xfixed& operator >>= (int n)				{ raw >>= n; return *this; }
+	xm_inline xfixed& operator <<= (int n)				{ raw <<= n; return *this; }
+
+	xm_inline xfixed operator + (xfixed f) const		{ return xfixed(*this) += f; }
+	xm_inline xfixed operator - (xfixed f) const		{ return xfixed(*this) -= f; }
+	xm_inline xfixed operator * (xfixed f) const		{ return xfixed(*this) *= f; }
+	xm_inline xfixed operator / (xfixed f) const		{ return xfixed(*this) /= f; }
+	xm_inline xfixed operator * (int i) const			{ return xfixed(*this) *= i; }
+	xm_inline xfixed operator / (int i) const			{ return xfixed(*this) /= i; }
+	xm_inline xfixed operator >> (int n) const			{ return xfixed(*this) >>= n; }
+	xm_inline xfixed operator << (int n) const			{ return xfixed(*this) <<= n; }
+
+	xm_inline bool operator == (xfixed f) const			{ return raw == f.raw; }
+	xm_inline bool operator != (xfixed f) const			{ return raw != f.raw; }
+	xm_inline bool operator < (xfixed f) const			{ return raw < f.raw; }
+	xm_inline bool operator > (xfixed f) const			{ return raw > f.raw; }
+	xm_inline bool operator <= (xfixed f) const			{ return raw <= f.raw; }
+	xm_inline bool operator >= (xfixed f) const			{ return raw >= f.raw; }
+
+	static const xfixed ZERO;
+	static const xfixed ID;
+	static const xfixed PI;
+	static const xfixed PI_2;
+	static const xfixed PI2;
+};
+
+namespace xfx {
+	xm_inline xfixed abs(xfixed f) { return f.raw < 0 ? -f : f; }
+
+	///Clamps 64 bit raw value with 16 fractional bits into xfixed range, asserts on overflow
+	xm_inline xfixed saturate(int64_t raw) { return xfixed::fromRaw64(raw); }
+	///Product as 64 bit raw value with 16 fractional bits, doesn't overflow
+	xm_inline int64_t mul64(xfixed a, xfixed b) { return (static_cast<int64_t>(a.raw) * b.raw) >> xfixed::FRACTION_BITS; }
+	///Square with 32 fractional bits
+	xm_inline uint64_t sqr64(xfixed a) { return static_cast<uint64_t>(static_cast<int64_t>(a.raw) * a.raw); }
+	///Square in same scale as Vect2x/Vect3x norm2() and distance2(), compare them against this
+	xm_inline int64_t sqr(xfixed a) { return static_cast<int64_t>(sqr64(a) >> xfixed::FRACTION_BITS); }
+	xm_inline xfixed min(xfixed a, xfixed b) { return a < b ? a : b; }
+	xm_inline xfixed max(xfixed a, xfixed b) { return a > b ? a : b; }
+
+	///Square root, negative arguments return 0
+	xfixed sqrt(xfixed f);
+	///Integer square root of 64 bit value
+	uint32_t isqrt(uint64_t v);
+
+	///Angles are in radians
+	xfixed sin(xfixed angle);
+	xfixed cos(xfixed angle);
+	void sincos(xfixed angle, xfixed& sin_out, xfixed& cos_out);
+	xfixed atan2(xfixed y, xfixed x);
+
+	///Wraps angle into [-PI, PI)
+	xfixed normalizeAngle(xfixed angle);
+
+	///Checksum of a fixed sequence of computations over this library,
+	///must be equal to XFIXED_CHECKSUM on every build
+	uint32_t checksum();
+}
+
+//Expected result of xfx::checksum(), any difference means library isn't deterministic in this build
+const uint32_t XFIXED_CHECKSUM = 0x574EEF46;
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//			class Vect2x
+//
+///////////////////////////////////////////////////////////////////////////////
+
+class Vect2x
+{
+public:
+	xfixed x, y;
+
+	xm_inline Vect2x() = default;
+	xm_inline Vect2x(xfixed x_, xfixed y_)				{ x = x_; y = y_; }
+	xm_inline explicit Vect2x(const Vect2f& v)			{ x = xfixed(v.x); y = xfixed(v.y); }
+	xm_inline explicit Vect2x(const Vect2i& v)			{ x = xfixed(v.x); y = xfixed(v.y); }
+
+	xm_inline Vect2x& set(xfixed x_, xfixed y_)			{ x = x_; y = y_; return *this; }
+	xm_inline Vect2f toVect2f() const					{ return Vect2f(x.toFloat(), y.toFloat()); }
+	xm_inline Vect2i toVect2i() const					{ return Vect2i(x.round(), y.round()); }
+
+	xm_inline Vect2x operator - () const				{ return Vect2x(-x, -y); }
+
+	xm_inline const xfixed& operator[](int i) const		{ return *(&x + i); }
+	xm_inline xfixed& operator[](int i)					{ return *(&x + i); }
+
+	xm_inline Vect2x& operator += (const Vect2x& v)		{ x += v.x; y += v.y; return *this; }
+	xm_inline Vect2x& operator -= (const Vect2x& v)		{ x -= v.x; y -= v.y; return *this; }
+	xm_inline Vect2x& operator *= (xfixed f)			{ x *= f; y *= f; return *this; }
+	xm_inline Vect2x& operator /= (xfixed f)			{ x /= f; y /= f; return *this; }
+
+	xm_inline Vect2x operator + (const Vect2x& v) const	{ return Vect2x(*this) += v; }
+	xm_inline Vect2x operator - (const Vect2x& v) const	{ return Vect2x(*this) -= v; }
+	xm_inline Vect2x operator * (xfixed f) const		{ return Vect2x(*this) *= f; }
+	xm_inline Vect2x operator / (xfixed f) const		{ return Vect2x(*this) /= f; }
+
+	xm_inline bool operator == (const Vect2x& v) const	{ return x == v.x && y == v.y; }
+	xm_inline bool operator != (const Vect2x& v) const	{ return x != v.x || y != v.y; }
+
+	///Saturates if result is out of xfixed range
+	xm_inline xfixed dot(const Vect2x& v) const			{ return xfx::saturate(dot64(v)); }
+	xm_inline xfixed operator % (const Vect2x& v) const	{ return x * v.y - y * v.x; }
+
+	///Dot product as 64 bit raw value with 16 fractional bits, exact for whole xfixed range
+	xm_inline int64_t dot64(const Vect2x& v) const		{ return xfx::mul64(x, v.x) + xfx::mul64(y, v.y); }
+	///Squared norm with 32 fractional bits, can't overflow as every term is positive
+	xm_inline uint64_t raw_norm2() const				{ return xfx::sqr64(x) + xfx::sqr64(y); }
+	///Saturates if norm is out of xfixed range
+	xm_inline xfixed norm() const						{ return xfx::saturate(static_cast<int64_t>(xfx::isqrt(raw_norm2()))); }
+	///Squared values don't fit xfixed on map scale, see xfx::sqr
+	xm_inline int64_t norm2() const						{ return static_cast<int64_t>(raw_norm2() >> xfixed::FRACTION_BITS); }
+	xm_inline xfixed distance(const Vect2x& v) const	{ return (*this - v).norm(); }
+	xm_inline int64_t distance2(const Vect2x& v) const	{ return (*this - v).norm2(); }
+	xm_inline void normalize(xfixed norma)				{ xfixed n = norm(); if(n.raw){ x = x * norma / n; y = y * norma / n; } }
+
+	static const Vect2x ZERO;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//			class Vect3x
+//
+///////////////////////////////////////////////////////////////////////////////
+
+class Vect3x
+{
+public:
+	xfixed x, y, z;
+
+	xm_inline Vect3x() = default;
+	xm_inline Vect3x(xfixed x_, xfixed y_, xfixed z_)	{ x = x_; y = y_; z = z_; }
+	xm_inline Vect3x(const Vect2x& v, xfixed z_)		{ x = v.x; y = v.y; z = z_; }
+	xm_inline explicit Vect3x(const Vect3f& v)			{ x = xfixed(v.x); y = xfixed(v.y); z = xfixed(v.z); }
+
+	xm_inline Vect3x& set(xfixed x_, xfixed y_, xfixed z_) { x = x_; y = y_; z = z_; return *this; }
+	xm_inline Vect3f toVect3f() const					{ return Vect3f(x.toFloat(), y.toFloat(), z.toFloat()); }
+	xm_inline Vect2x xy() const							{ return Vect2x(x, y); }
+
+	xm_inline Vect3x operator - () const				{ return Vect3x(-x, -y, -z); }
+
+	xm_inline const xfixed& operator[](int i) const		{ return *(&x + i); }
+	xm_inline xfixed& operator[](int i)					{ return *(&x + i); }
+
+	xm_inline Vect3x& operator += (const Vect3x& v)		{ x += v.x; y += v.y; z += v.z; return *this; }
+	xm_inline Vect3x& operator -= (const Vect3x& v)		{ x -= v.x; y -= v.y; z -= v.z; return *this; }
+	xm_inline Vect3x& operator *= (xfixed f)			{ x *= f; y *= f; z *= f; return *this; }
+	xm_inline Vect3x& operator /= (xfixed f)			{ x /= f; y /= f; z /= f; return *this; }
+
+	xm_inline Vect3x operator + (const Vect3x& v) const	{ return Vect3x(*this) += v; }
+	xm_inline Vect3x operator - (const Vect3x& v) const	{ return Vect3x(*this) -= v; }
+	xm_inline Vect3x operator * (xfixed f) const		{ return Vect3x(*this) *= f; }
+	xm_inline Vect3x operator / (xfixed f) const		{ return Vect3x(*this) /= f; }
+
+	xm_inline bool operator == (const Vect3x& v) const	{ return x == v.x && y == v.y && z == v.z; }
+	xm_inline bool operator != (const Vect3x& v) const	{ return x != v.x || y != v.y || z != v.z; }
+
+	///Saturates if result is out of xfixed range
+	xm_inline xfixed dot(const Vect3x& v) const			{ return xfx::saturate(dot64(v)); }
+	xm_inline Vect3x operator % (const Vect3x& v) const	{ return Vect3x(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x); }
+
+	///Dot product as 64 bit raw value with 16 fractional bits, exact for whole xfixed range
+	xm_inline int64_t dot64(const Vect3x& v) const		{ return xfx::mul64(x, v.x) + xfx::mul64(y, v.y) + xfx::mul64(z, v.z); }
+	///Squared norm with 32 fractional bits, can't overflow as every term is positive
+	xm_inline uint64_t raw_norm2() const				{ return xfx::sqr64(x) + xfx::sqr64(y) + xfx::sqr64(z); }
+	///Saturates if norm is out of xfixed range
+	xm_inline xfixed norm() const						{ return xfx::saturate(static_cast<int64_t>(xfx::isqrt(raw_norm2()))); }
+	///Squared values don't fit xfixed on map scale, see xfx::sqr
+	xm_inline int64_t norm2() const						{ return static_cast<int64_t>(raw_norm2() >> xfixed::FRACTION_BITS); }
+	xm_inline xfixed distance(const Vect3x& v) const	{ return (*this - v).norm(); }
+	xm_inline int64_t distance2(const Vect3x& v) const	{ return (*this - v).norm2(); }
+	xm_inline void normalize(xfixed norma)				{ xfixed n = norm(); if(n.raw){ x = x * norma / n; y = y * norma / n; z = z * norma / n; } }
+
+	static const Vect3x ZERO;
+};
+
+#endif //__XFIXED_H__
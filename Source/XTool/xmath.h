@@ -12,6 +12,10 @@
 #include "SerializationMacro.h"
 #include "tweaks.h"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 //#define _XMATH_USE_IOSTREAM
 
 #ifdef _XMATH_USE_IOSTREAM
@@ -155,6 +159,20 @@ inline int BitSR(int x) {
     return 0;
 }
 
+//Index of lowest set bit, x must be non zero
+xm_inline int BitSF64(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<unsigned long>(x))) {
+        return static_cast<int>(index);
+    }
+    _BitScanForward(&index, static_cast<unsigned long>(x >> 32));
+    return static_cast<int>(index) + 32;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
 template <class T> 
 xm_inline T sqr(const T& x){ return x*x; }
 
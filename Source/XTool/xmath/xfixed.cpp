@@ -0,0 +1,169 @@
+//Deterministic fixed-point math, only integer operations are used here
+
+#include "xfixed.h"
+
+const xfixed xfixed::ZERO = xfixed::fromRaw(0);
+const xfixed xfixed::ID = xfixed::fromRaw(xfixed::ONE);
+const xfixed xfixed::PI = xfixed::fromRaw(205887);
+const xfixed xfixed::PI_2 = xfixed::fromRaw(102944);
+const xfixed xfixed::PI2 = xfixed::fromRaw(411775);
+
+const Vect2x Vect2x::ZERO = Vect2x(xfixed::ZERO, xfixed::ZERO);
+const Vect3x Vect3x::ZERO = Vect3x(xfixed::ZERO, xfixed::ZERO, xfixed::ZERO);
+
+//CORDIC tables: atan(2^-i) in 16.16 radians and 1/gain
+static const int CORDIC_ITERATIONS = 16;
+static const int32_t cordic_atan[CORDIC_ITERATIONS] = {
+	51472, 30386, 16055, 8150, 4091, 2047, 1024, 512,
+	256, 128, 64, 32, 16, 8, 4, 2
+};
+static const int32_t CORDIC_INV_GAIN = 39797;
+
+namespace xfx {
+
+uint32_t isqrt(uint64_t v) {
+	uint64_t result = 0;
+	uint64_t bit = static_cast<uint64_t>(1) << 62;
+	while (bit > v) {
+		bit >>= 2;
+	}
+	while (bit) {
+		if (v >= result + bit) {
+			v -= result + bit;
+			result = (result >> 1) + bit;
+		} else {
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return static_cast<uint32_t>(result);
+}
+
+xfixed sqrt(xfixed f) {
+	if (f.raw <= 0) return xfixed::ZERO;
+	return xfixed::fromRaw(static_cast<int32_t>(isqrt(static_cast<uint64_t>(f.raw) << xfixed::FRACTION_BITS)));
+}
+
+xfixed normalizeAngle(xfixed angle) {
+	int32_t a = angle.raw % xfixed::PI2.raw;
+	if (a >= xfixed::PI.raw) a -= xfixed::PI2.raw;
+	else if (a < -xfixed::PI.raw) a += xfixed::PI2.raw;
+	return xfixed::fromRaw(a);
+}
+
+void sincos(xfixed angle, xfixed& sin_out, xfixed& cos_out) {
+	//CORDIC converges for |z| <= ~1.74, fold other half of circle by PI rotation
+	int32_t z = normalizeAngle(angle).raw;
+	bool negate = false;
+	if (z > xfixed::PI_2.raw) {
+		z -= xfixed::PI.raw;
+		negate = true;
+	} else if (z < -xfixed::PI_2.raw) {
+		z += xfixed::PI.raw;
+		negate = true;
+	}
+
+	int64_t x = CORDIC_INV_GAIN;
+	int64_t y = 0;
+	for (int i = 0; i < CORDIC_ITERATIONS; i++) {
+		int64_t dx = y >> i;
+		int64_t dy = x >> i;
+		if (z >= 0) {
+			x -= dx;
+			y += dy;
+			z -= cordic_atan[i];
+		} else {
+			x += dx;
+			y -= dy;
+			z += cordic_atan[i];
+		}
+	}
+
+	if (negate) {
+		x = -x;
+		y = -y;
+	}
+	cos_out = xfixed::fromRaw(static_cast<int32_t>(x));
+	sin_out = xfixed::fromRaw(static_cast<int32_t>(y));
+}
+
+xfixed sin(xfixed angle) {
+	xfixed s, c;
+	sincos(angle, s, c);
+	return s;
+}
+
+xfixed cos(xfixed angle) {
+	xfixed s, c;
+	sincos(angle, s, c);
+	return c;
+}
+
+xfixed atan2(xfixed fy, xfixed fx) {
+	if (fx.raw == 0 && fy.raw == 0) return xfixed::ZERO;
+
+	int64_t x = fx.raw;
+	int64_t y = fy.raw;
+	int32_t z = 0;
+	//Vectoring mode works in right half-plane, rotate by PI otherwise
+	if (x < 0) {
+		x = -x;
+		y = -y;
+		z = fy.raw >= 0 ? xfixed::PI.raw : -xfixed::PI.raw;
+	}
+
+	for (int i = 0; i < CORDIC_ITERATIONS; i++) {
+		int64_t dx = y >> i;
+		int64_t dy = x >> i;
+		if (y > 0) {
+			x += dx;
+			y -= dy;
+			z += cordic_atan[i];
+		} else {
+			x -= dx;
+			y += dy;
+			z -= cordic_atan[i];
+		}
+	}
+
+	return normalizeAngle(xfixed::fromRaw(z));
+}
+
+uint32_t checksum() {
+	//FNV-1a over results of every library function fed with a deterministic sequence
+	uint32_t hash = 2166136261u;
+	auto mix = [&hash](xfixed f) {
+		uint32_t v = static_cast<uint32_t>(f.raw);
+		for (int i = 0; i < 4; i++) {
+			hash ^= (v >> (i * 8)) & 0xFF;
+			hash *= 16777619u;
+		}
+	};
+
+	Vect3x position(xfixed(512), xfixed(384), xfixed(16));
+	Vect3x velocity(xfixed::fromRatio(3, 2), xfixed::fromRatio(-7, 4), xfixed::ZERO);
+	xfixed angle = xfixed::ZERO;
+	for (int i = 0; i < 1024; i++) {
+		xfixed s, c;
+		sincos(angle, s, c);
+		Vect3x acceleration(c, s, xfixed::fromRatio(-1, 8));
+		velocity += acceleration / 4;
+		velocity.normalize(xfixed(3));
+		position += velocity;
+
+		xfixed dist = position.distance(Vect3x(xfixed(512), xfixed(512), xfixed::ZERO));
+		angle = atan2(velocity.y, velocity.x) + xfixed::fromRatio(i % 17, 11);
+
+		mix(s);
+		mix(c);
+		mix(dist);
+		mix(angle);
+		mix(sqrt(xfixed::fromRaw(i * 7919)));
+		mix(position.x);
+		mix(position.y);
+		mix(position.z);
+	}
+	return hash;
+}
+
+}
@@ -107,6 +107,31 @@ float CachingTurbulator3D::turbulate3D(const Vector3D &v, float persistence, int
 	}
 }
 
+void CachingTurbulator3D::turbulateRow(const Vector3D* v, float* dest, int count, float persistence, int octaveCount, Interpolator3D *interpolator) {
+	//single point cache does not help a row, it's left untouched
+	if (count <= 0) {
+		return;
+	}
+	rowFreqV.resize(count);
+	rowValues.resize(count);
+	int i;
+	for (i = 0; i < count; i++) {
+		dest[i] = 0.0;
+	}
+	float ampl = 1.0;
+	for (int o = 0; o < octaveCount; o++) {
+		for (i = 0; i < count; i++) {
+			rowFreqV[i] = v[i];
+			rowFreqV[i] *= freqs[o];
+		}
+		interpolator->interpolateRow(&rowFreqV[0], &rowValues[0], count);
+		for (i = 0; i < count; i++) {
+			dest[i] += rowValues[i] * ampl;
+		}
+		ampl *= persistence;
+	}
+}
+
 CachingTurbulator3D::CachingTurbulator3D(int maximumOctaveCount) {
 	lastPersistence = 0.0;
 	lastOctaveCount = 0;
@@ -16,6 +16,7 @@
 #define _TX3D_CACHINGTURBULATOR3D_H
 
 #include "Turbulator3D.hpp"
+#include <vector>
 
 namespace tx3d {
 
@@ -35,6 +36,7 @@ namespace tx3d {
 			}
 
 			float turbulate3D(const Vector3D &v, float persistence, int octaveCount, Interpolator3D *interpolator);
+			void turbulateRow(const Vector3D* v, float* dest, int count, float persistence, int octaveCount, Interpolator3D *interpolator);
 
 		protected :
 			void clearCache();
@@ -57,6 +59,9 @@ namespace tx3d {
 			int lastInterpolationCount;
 
 			Vector3D freqV;
+
+			std::vector<Vector3D> rowFreqV;
+			std::vector<float> rowValues;
 	};
 
 }
@@ -15,6 +15,7 @@
 
 #include "Texture3D.hpp"
 #include "Texture3DUtils.hpp"
+#include <vector>
 //#include "xutil.h"
 
 namespace tx3d {
@@ -49,6 +50,21 @@ namespace tx3d {
 				return indexLattice[index & 65535];
 			}
 
+			void getColorIndexRow(const Vector3D* v, unsigned char* dest, int count) {
+				if (count <= 0) {
+					return;
+				}
+				rowColors.resize(count);
+				texture->getColorRow(&rowColors[0], v, count);
+				for (int i = 0; i < count; i++) {
+					const Vector3D& clr = rowColors[i];
+					int index =	  Texture3DUtils::floor(clr.x * 31.0) * 2048
+								+ Texture3DUtils::floor(clr.y * 63.0) * 32
+								+ Texture3DUtils::floor(clr.z * 31.0);
+					dest[i] = indexLattice[index & 65535];
+				}
+			}
+
 			unsigned char getHSBColorIndex(const Vector3D &v) {
 				Vector3D clr;
 				texture->getColor(&clr, v);
@@ -90,6 +106,8 @@ namespace tx3d {
 			}
 
 			Texture3D* texture;
+
+			std::vector<Vector3D> rowColors;
 	};
 
 }
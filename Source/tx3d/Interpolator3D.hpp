@@ -24,6 +24,11 @@ namespace tx3d {
 		public:
 			virtual ~Interpolator3D() {}
 			virtual float interpolate(const Vector3D &v) = 0;
+			virtual void interpolateRow(const Vector3D* v, float* dest, int count) {
+				for (int i = 0; i < count; i++) {
+					dest[i] = interpolate(v[i]);
+				}
+			}
 	};
 
 }
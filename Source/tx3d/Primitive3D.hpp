@@ -17,6 +17,7 @@
 #include "Colorizer3D.hpp"
 #include "Turbulator3D.hpp"
 #include "Interpolator3D.hpp"
+#include <vector>
 
 namespace tx3d {
 
@@ -64,6 +65,24 @@ namespace tx3d {
 																  interpolator )  );
 			}
 
+			void getColorRow(Vector3D* destClr, const Vector3D* v, int count) {
+				if (count <= 0) {
+					return;
+				}
+				rowShiftedV.resize(count);
+				rowValues.resize(count);
+				int i;
+				for (i = 0; i < count; i++) {
+					rowShiftedV[i] = v[i];
+					rowShiftedV[i] &= scale;
+					rowShiftedV[i] += shift;
+				}
+				turbulator->turbulateRow(&rowShiftedV[0], &rowValues[0], count, persistence, octaveCount, interpolator);
+				for (i = 0; i < count; i++) {
+					colorizer->computeColor(destClr + i, rowShiftedV[i], rowValues[i]);
+				}
+			}
+
 			void zoom(float degree) {
 				shift *= degree;
 				scale /= degree;
@@ -113,6 +132,9 @@ namespace tx3d {
 			Turbulator3D *turbulator;
 
 			Vector3D shiftedV;
+
+			std::vector<Vector3D> rowShiftedV;
+			std::vector<float> rowValues;
 	};
 
 }
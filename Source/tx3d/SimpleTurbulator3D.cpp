@@ -27,3 +27,26 @@ float SimpleTurbulator3D::turbulate3D(const Vector3D &v, float persistence, int
 	return sum;
 }
 
+void SimpleTurbulator3D::turbulateRow(const Vector3D* v, float* dest, int count, float persistence, int octaveCount, Interpolator3D *interpolator) {
+	if (count <= 0) {
+		return;
+	}
+	rowFreqV.assign(v, v + count);
+	rowValues.resize(count);
+	int i;
+	for (i = 0; i < count; i++) {
+		dest[i] = 0.0;
+	}
+	float ampl = 1.0;
+	for (int o = 0; o < octaveCount; o++) {
+		interpolator->interpolateRow(&rowFreqV[0], &rowValues[0], count);
+		for (i = 0; i < count; i++) {
+			dest[i] += rowValues[i] * ampl;
+		}
+		for (i = 0; i < count; i++) {
+			rowFreqV[i] *= 2.0;
+		}
+		ampl *= persistence;
+	}
+}
+
@@ -15,6 +15,7 @@
 
 #include "Turbulator3D.hpp"
 #include <memory> // std::auto_ptr
+#include <vector>
 
 namespace tx3d {
 
@@ -22,6 +23,7 @@ namespace tx3d {
 		public :
 
 			float turbulate3D(const Vector3D &v, float persistence, int octaveCount, Interpolator3D *interpolator);
+			void turbulateRow(const Vector3D* v, float* dest, int count, float persistence, int octaveCount, Interpolator3D *interpolator);
 
 			static SimpleTurbulator3D* getSharedSimpleTurbulator3D() {
 				if (!sharedInstance.get()) {
@@ -33,6 +35,9 @@ namespace tx3d {
 		protected:
 			static std::unique_ptr<SimpleTurbulator3D> sharedInstance;
 			Vector3D freqV;
+
+			std::vector<Vector3D> rowFreqV;
+			std::vector<float> rowValues;
 	};
 
 }
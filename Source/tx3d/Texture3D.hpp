@@ -24,6 +24,11 @@ namespace tx3d {
 		public:
             ~Texture3D() override = default;
 			virtual void getColor(Vector3D* destClr, const Vector3D &v) = 0;
+			virtual void getColorRow(Vector3D* destClr, const Vector3D* v, int count) {
+				for (int i = 0; i < count; i++) {
+					getColor(destClr + i, v[i]);
+				}
+			}
 			virtual void zoom(float degree) {
 			};
 			virtual void zoomColor(float degree) {
@@ -22,6 +22,12 @@ namespace tx3d {
 		public :
 			virtual ~Turbulator3D() {} 
 			virtual float turbulate3D(const Vector3D &v, float persistence, int octaveCount, Interpolator3D *interpolator) = 0;
+			//for-performance-purposes: octave by octave over whole row of points
+			virtual void turbulateRow(const Vector3D* v, float* dest, int count, float persistence, int octaveCount, Interpolator3D *interpolator) {
+				for (int i = 0; i < count; i++) {
+					dest[i] = turbulate3D(v[i], persistence, octaveCount, interpolator);
+				}
+			}
 	};
 
 }